@@ -0,0 +1,470 @@
+/**
+* @file TD_SHT31_benchmark.ino
+* @brief
+* This code measures time spent in TD_SHT31 measurement paths and prints
+* one JSON object per line, so results can be compared between releases.
+
+* Measured paths:
+* - runSingleShot (CMD_SS_CSD_LOW), includes conversion wait.
+* - startSingleShot + pollSingleShot, bus and decode time only.
+* - fetchPeriodic (10 mps), single fetch without conversion wait.
+* Every path is run with CRC enabled/disabled and Celsius/Farenheit.
+* - Array sweep of sensors 0x44 and 0x45: TD_SHT31Bus::runAll versus
+*   looping runSingleShot, wall time and bus bytes per sweep.
+* - fetchPeriodic transaction time at 100 kHz, 400 kHz and 1 MHz I2C clock.
+*   Board must support the clock, e.g. Uno is limited to 400 kHz.
+* - TD_SHT31Psychro dew point, absolute humidity and heat index versus float
+*   reference formulas with expf/logf.
+* - TD_SHT31::crc8 versus bitwise reference CRC, no bus. Library method is
+*   selected with build flag, e.g. -DTD_SHT31_CRC_METHOD=CRC_TABLE.
+* - Raw tick converters and 6 byte frame decode (CRC check and integer
+*   conversion), no bus.
+* Times are printed in ns, resolution is that of micros() divided by the
+* number of samples or calls (e.g. 4 us on 16 MHz AVR).
+
+* Interface:
+* Sensor         Arduino Uno Board
+* --------------------------------
+* Vin (3.3V)      3.3V
+* Gnd             Gnd
+* SDA             A4
+* SCK             A5
+* --------------------------------
+*
+* Written by Honee52.
+ */
+
+#include <TD_SHT31.h>
+#include <TD_SHT31Bus.h>
+#include <TD_SHT31Psychro.h>
+
+/**
+ * ----------------------------------------------------------------------------
+ * Define SHT31 and variables.
+ * ----------------------------------------------------------------------------
+ */
+#define SAMPLES 50
+
+TD_SHT31 sht(0x44);
+TD_SHT31 sht2(0x45);
+TD_SHT31Bus bus;
+float temperat_o, humidity_o;
+
+/**
+ * ----------------------------------------------------------------------------
+ * Return ns per sample, scaled before division to keep sub-us part.
+ * ----------------------------------------------------------------------------
+*/
+uint32_t nsPer(uint32_t u32Time, uint16_t u16Count)
+{
+  return (uint32_t) (((uint64_t) u32Time * 1000ULL) / u16Count);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * Print one result line.
+ * ----------------------------------------------------------------------------
+*/
+void printResult(const char *path, bool useCRC, bool tUnit, uint32_t u32Time,
+                 uint16_t u16Errors)
+{
+  Serial.print("{\"path\":\"");
+  Serial.print(path);
+  Serial.print("\",\"crc\":");
+  Serial.print(useCRC ? "true" : "false");
+  Serial.print(",\"unit\":\"");
+  Serial.print(tUnit ? "C" : "F");
+  Serial.print("\",\"samples\":");
+  Serial.print(SAMPLES);
+  Serial.print(",\"errors\":");
+  Serial.print(u16Errors);
+  Serial.print(",\"ns_per_sample\":");
+  Serial.print(nsPer(u32Time, SAMPLES));
+  Serial.println("}");
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * Benchmarks.
+ * ----------------------------------------------------------------------------
+*/
+uint32_t benchRunSingleShot(uint16_t *u16Errors)
+{
+  uint32_t u32Start = micros();
+  for (uint16_t i = 0; i < SAMPLES; i++)
+  {
+    if (sht.runSingleShot(CMD_SS_CSD_LOW, &temperat_o, &humidity_o) == false)
+    {
+      (*u16Errors)++;
+    }
+  }
+  return micros() - u32Start;
+}
+
+uint32_t benchPollSingleShot(uint16_t *u16Errors)
+{
+  uint32_t u32Time = 0;
+  for (uint16_t i = 0; i < SAMPLES; i++)
+  {
+    uint32_t u32Start = micros();
+    if (sht.startSingleShot(CMD_SS_CSD_LOW) == false)
+    {
+      (*u16Errors)++;
+      continue;
+    }
+    u32Time += micros() - u32Start;
+    delay(5);
+
+    u32Start = micros();
+    if (sht.pollSingleShot(&temperat_o, &humidity_o) != MEAS_READY)
+    {
+      (*u16Errors)++;
+    }
+    u32Time += micros() - u32Start;
+  }
+  return u32Time;
+}
+
+uint32_t benchFetchPeriodic(uint16_t *u16Errors)
+{
+  uint32_t u32Time = 0;
+  if (sht.startPeriodic(PER_RATE_10, REPEAT_LOW) == false)
+  {
+    *u16Errors = SAMPLES;
+    return 0;
+  }
+  for (uint16_t i = 0; i < SAMPLES; i++)
+  {
+    delay(100); /* 10 mps */
+    uint32_t u32Start = micros();
+    if (sht.fetchPeriodic(&temperat_o, &humidity_o) == false)
+    {
+      (*u16Errors)++;
+    }
+    u32Time += micros() - u32Start;
+  }
+  sht.stopPeriodic();
+  return u32Time;
+}
+
+void printSweep(const char *path, uint32_t u32Time, uint32_t u32Bytes,
+                uint16_t u16Errors)
+{
+  Serial.print("{\"path\":\"");
+  Serial.print(path);
+  Serial.print("\",\"sensors\":2,\"samples\":");
+  Serial.print(SAMPLES);
+  Serial.print(",\"errors\":");
+  Serial.print(u16Errors);
+  Serial.print(",\"bus_bytes_per_sweep\":");
+  Serial.print(u32Bytes);
+  Serial.print(",\"ns_per_sweep\":");
+  Serial.print(nsPer(u32Time, SAMPLES));
+  Serial.println("}");
+}
+
+void benchSweep()
+{
+  uint16_t u16Errors = 0;
+  sht.getBusBytes();
+  sht2.getBusBytes();
+  uint32_t u32Start = micros();
+  for (uint16_t i = 0; i < SAMPLES; i++)
+  {
+    if (sht.runSingleShot(CMD_SS_CSD_HIGH, &temperat_o, &humidity_o) == false)
+    {
+      u16Errors++;
+    }
+    if (sht2.runSingleShot(CMD_SS_CSD_HIGH, &temperat_o, &humidity_o) == false)
+    {
+      u16Errors++;
+    }
+  }
+  uint32_t u32Time = micros() - u32Start;
+  uint32_t u32Bytes = sht.getBusBytes() + sht2.getBusBytes();
+  printSweep("loopRunSingleShot", u32Time, u32Bytes / SAMPLES, u16Errors);
+
+  u16Errors = 0;
+  bus.getBusBytes();
+  u32Start = micros();
+  for (uint16_t i = 0; i < SAMPLES; i++)
+  {
+    if (bus.runAll(CMD_SS_CSD_HIGH) == false)
+    {
+      u16Errors++;
+    }
+  }
+  u32Time = micros() - u32Start;
+  printSweep("busRunAll", u32Time, bus.getBusBytes() / SAMPLES, u16Errors);
+}
+
+void benchClock()
+{
+  const uint32_t clocks[3] = { I2C_CLOCK_100K, I2C_CLOCK_400K, I2C_CLOCK_1M };
+
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    uint16_t u16Errors = 0;
+    sht.setClock(clocks[i]);
+    uint32_t u32Time = benchFetchPeriodic(&u16Errors);
+    Serial.print("{\"path\":\"fetchPeriodic\",\"clock_hz\":");
+    Serial.print(clocks[i]);
+    Serial.print(",\"samples\":");
+    Serial.print(SAMPLES);
+    Serial.print(",\"errors\":");
+    Serial.print(u16Errors);
+    Serial.print(",\"ns_per_sample\":");
+    Serial.print(nsPer(u32Time, SAMPLES));
+    Serial.println("}");
+  }
+  sht.setClock(I2C_CLOCK_100K);
+}
+
+void printCalls(const char *path, uint32_t u32Time, uint16_t u16Count)
+{
+  Serial.print("{\"path\":\"");
+  Serial.print(path);
+  Serial.print("\",\"calls\":");
+  Serial.print(u16Count);
+  Serial.print(",\"ns_per_call\":");
+  Serial.print(nsPer(u32Time, u16Count));
+  Serial.println("}");
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * Bitwise CRC-8 reference (CRC_BITWISE method).
+ * ----------------------------------------------------------------------------
+*/
+uint8_t crc8Bitwise(const uint8_t *data, uint8_t len)
+{
+  uint8_t crc = 0xFF;
+  for (uint8_t j = 0; j < len; j++)
+  {
+    crc ^= data[j];
+    for (uint8_t i = 0; i < 8; i++)
+    {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+void benchCrc()
+{
+  const uint16_t u16Count = 1000;
+  volatile uint8_t u8Sink = 0;
+  uint8_t data[2];
+  uint16_t u16Mismatch = 0;
+  uint32_t u32Start;
+
+  u32Start = micros();
+  for (uint16_t i = 0; i < u16Count; i++)
+  {
+    data[0] = i >> 8;
+    data[1] = i & 0xFF;
+    u8Sink += crc8Bitwise(data, 2);
+  }
+  printCalls("crc8Bitwise", micros() - u32Start, u16Count);
+
+  u32Start = micros();
+  for (uint16_t i = 0; i < u16Count; i++)
+  {
+    data[0] = i >> 8;
+    data[1] = i & 0xFF;
+    u8Sink += TD_SHT31::crc8(data, 2);
+  }
+  printCalls("crc8Library", micros() - u32Start, u16Count);
+
+  for (uint16_t i = 0; i < u16Count; i++)
+  {
+    data[0] = i >> 8;
+    data[1] = i & 0xFF;
+    if (TD_SHT31::crc8(data, 2) != crc8Bitwise(data, 2))
+    {
+      u16Mismatch++;
+    }
+  }
+  Serial.print("{\"path\":\"crc8Check\",\"mismatches\":");
+  Serial.print(u16Mismatch);
+  Serial.println("}");
+}
+
+void benchDecode()
+{
+  const uint16_t u16Count = 1000;
+  volatile int32_t i32Sink = 0;
+  volatile float fSink = 0;
+  uint8_t frames[16][6];
+  uint32_t u32Start;
+
+  /* Frames with valid CRC, prepared outside timing */
+  for (uint8_t i = 0; i < 16; i++)
+  {
+    frames[i][0] = 0x60 + i;
+    frames[i][1] = 0x11 * i;
+    frames[i][2] = TD_SHT31::crc8(&frames[i][0], 2);
+    frames[i][3] = 0x80 - i;
+    frames[i][4] = 0x22 * i;
+    frames[i][5] = TD_SHT31::crc8(&frames[i][3], 2);
+  }
+
+  u32Start = micros();
+  for (uint16_t i = 0; i < u16Count; i++)
+  {
+    i32Sink += TD_SHT31::ticksToCentiCelsius(i * 65);
+    i32Sink += TD_SHT31::ticksToCentiHumidity(i * 65);
+  }
+  printCalls("ticksToCenti", micros() - u32Start, u16Count);
+
+  u32Start = micros();
+  for (uint16_t i = 0; i < u16Count; i++)
+  {
+    fSink += TD_SHT31::ticksToCelsius(i * 65);
+    fSink += TD_SHT31::ticksToHumidity(i * 65);
+  }
+  printCalls("ticksToFloat", micros() - u32Start, u16Count);
+
+  /* Same steps as library decode of sensor data */
+  u32Start = micros();
+  for (uint16_t i = 0; i < u16Count; i++)
+  {
+    const uint8_t *frame = frames[i & 15];
+    if ((frame[2] != TD_SHT31::crc8(frame, 2)) ||
+        (frame[5] != TD_SHT31::crc8(frame + 3, 2)))
+    {
+      continue;
+    }
+    uint16_t u16T = ((uint16_t) frame[0] << 8) + frame[1];
+    uint16_t u16H = ((uint16_t) frame[3] << 8) + frame[4];
+    i32Sink += TD_SHT31::ticksToCentiCelsius(u16T);
+    i32Sink += TD_SHT31::ticksToCentiHumidity(u16H);
+  }
+  printCalls("decodeFrame", micros() - u32Start, u16Count);
+}
+
+void benchPsychro()
+{
+  const uint16_t u16Count = 1000;
+  volatile int32_t i32Sink = 0;
+  volatile float fSink = 0;
+  uint32_t u32Start;
+
+  u32Start = micros();
+  for (uint16_t i = 0; i < u16Count; i++)
+  {
+    i32Sink += TD_SHT31Psychro::dewPoint(1000 + i, 2000 + 5 * i);
+  }
+  printCalls("dewPoint", micros() - u32Start, u16Count);
+
+  u32Start = micros();
+  for (uint16_t i = 0; i < u16Count; i++)
+  {
+    float t = (1000 + i) * 0.01f;
+    float g = logf((2000 + 5 * i) * 0.0001f) + 17.62f * t / (243.12f + t);
+    fSink += 243.12f * g / (17.62f - g);
+  }
+  printCalls("dewPointReference", micros() - u32Start, u16Count);
+
+  u32Start = micros();
+  for (uint16_t i = 0; i < u16Count; i++)
+  {
+    i32Sink += TD_SHT31Psychro::absoluteHumidity(1000 + i, 2000 + 5 * i);
+  }
+  printCalls("absoluteHumidity", micros() - u32Start, u16Count);
+
+  u32Start = micros();
+  for (uint16_t i = 0; i < u16Count; i++)
+  {
+    float t = (1000 + i) * 0.01f;
+    float e = 6.112f * expf(17.62f * t / (243.12f + t)) * (2000 + 5 * i) * 0.01f;
+    fSink += 2.16679f * e / (273.15f + t);
+  }
+  printCalls("absoluteHumidityReference", micros() - u32Start, u16Count);
+
+  u32Start = micros();
+  for (uint16_t i = 0; i < u16Count; i++)
+  {
+    i32Sink += TD_SHT31Psychro::heatIndex(2700 + i, 4000 + 5 * i);
+  }
+  printCalls("heatIndex", micros() - u32Start, u16Count);
+
+  u32Start = micros();
+  for (uint16_t i = 0; i < u16Count; i++)
+  {
+    float t = (2700 + i) * 0.018f + 32;
+    float rh = (4000 + 5 * i) * 0.01f;
+    fSink += (-42.379f + 2.04901523f * t + 10.14333127f * rh
+              - 0.22475541f * t * rh - 0.00683783f * t * t
+              - 0.05481717f * rh * rh + 0.00122874f * t * t * rh
+              + 0.00085282f * t * rh * rh - 0.00000199f * t * t * rh * rh - 32) / 1.8f;
+  }
+  printCalls("heatIndexReference", micros() - u32Start, u16Count);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * Setup
+ * ----------------------------------------------------------------------------
+*/
+void setup() {
+  /* Initialize serial port */
+  Serial.begin(115200);
+  while (!Serial) {
+    ; // Wait for serial port. Remove wait if not native USB port.
+  }
+  delay(1000);
+
+  if (sht.begin() == false)
+  {
+    Serial.print("Error in begin(): 0b"); 
+    Serial.println(sht.getLastError(), BIN);
+    while (true) { ; }
+  }
+  sht2.begin();
+  bus.addSensor(&sht);
+  bus.addSensor(&sht2);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * Main loop.
+ * ----------------------------------------------------------------------------
+*/
+void loop() {
+  const bool crcModes[2]  = { ENABLE_CRC, DISABLE_CRC };
+  const bool unitModes[2] = { CELSIUS, FARENHEIT };
+
+  for (uint8_t c = 0; c < 2; c++)
+  {
+    for (uint8_t u = 0; u < 2; u++)
+    {
+      uint16_t u16Errors;
+      uint32_t u32Time;
+      sht.set_defaults(crcModes[c], unitModes[u]);
+
+      u16Errors = 0;
+      u32Time = benchRunSingleShot(&u16Errors);
+      printResult("runSingleShot", crcModes[c], unitModes[u], u32Time, u16Errors);
+
+      u16Errors = 0;
+      u32Time = benchPollSingleShot(&u16Errors);
+      printResult("pollSingleShot", crcModes[c], unitModes[u], u32Time, u16Errors);
+
+      u16Errors = 0;
+      u32Time = benchFetchPeriodic(&u16Errors);
+      printResult("fetchPeriodic", crcModes[c], unitModes[u], u32Time, u16Errors);
+    }
+  }
+  sht.set_defaults(ENABLE_CRC, CELSIUS);
+  benchSweep();
+  benchClock();
+  benchPsychro();
+  benchCrc();
+  benchDecode();
+  sht.getLastError();
+  sht2.getLastError();
+  Serial.println(" ");
+
+  delay(10000);
+}
@@ -0,0 +1,70 @@
+/**
+* @file TD_SHT31_linux.cpp
+* @brief
+* This code shows how to use TD_SHT31 library on embedded Linux
+* (e.g. Raspberry Pi) with i2c-dev.
+*
+* Build:
+* g++ -O2 -DTD_SHT31_LINUX -I../../src ../../src/TD_SHT31*.cpp \
+*     TD_SHT31_linux.cpp -o sht31
+* Run:
+* ./sht31 [device] (default /dev/i2c-1)
+*
+* Written by Honee52.
+ */
+
+#include <TD_SHT31.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * ----------------------------------------------------------------------------
+ * Define SHT31.
+ * ----------------------------------------------------------------------------
+ */
+TD_SHT31 sht(0x44);
+
+/**
+ * ----------------------------------------------------------------------------
+ * Main.
+ * ----------------------------------------------------------------------------
+*/
+int main(int argc, char *argv[])
+{
+  if (argc > 1)
+  {
+    Wire.setDevice(argv[1]);
+  }
+  Wire.begin();
+  if (Wire.isOpen() == false)
+  {
+    perror("Can not open I2C device");
+    return 1;
+  }
+
+  sht.set_defaults(ENABLE_CRC, CELSIUS);
+  if (sht.begin() == false)
+  {
+    printf("Error in begin(): 0x%X\n", sht.getLastError());
+    return 1;
+  }
+  sht.setAdaptiveTiming(true);
+
+  while (true)
+  {
+    TD_SHT31Measurement m = sht.measure(CMD_SS_CSD_HIGH);
+    if (m.ok())
+    {
+      /* Sign separately, -0.50 C has integer part 0 */
+      printf("%lu ms: %s%d.%02d C, %d.%02d %%RH\n", (unsigned long) m.timestamp,
+             (m.temperature < 0) ? "-" : "",
+             abs(m.temperature / 100), abs(m.temperature % 100),
+             m.humidity / 100, m.humidity % 100);
+    } else
+    {
+      printf("Error: 0x%X\n", m.status);
+    }
+    delay(5000);
+  }
+  return 0;
+}
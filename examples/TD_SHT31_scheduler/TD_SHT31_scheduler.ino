@@ -0,0 +1,109 @@
+/**
+* @file TD_SHT31_scheduler.ino
+* @brief
+* This code shows how to use TD_SHT31Scheduler to read temperature and
+* humidity at fixed rate without blocking loop.
+*
+* Measurement is triggered every 5 seconds by internal period. To trigger
+* from hardware timer instead, call setPeriod(SCHED_EXTERNAL_TICK) and
+* scheduler.tick() from timer interrupt. Results are printed by callback
+* and jitter statistics every 10 cycles.
+*
+* Interface:
+* Sensor         Arduino Uno Board
+* --------------------------------
+* Vin (3.3V)      3.3V
+* Gnd             Gnd
+* SDA             A4
+* SCK             A5
+* --------------------------------
+*
+* Written by Honee52.
+ */
+
+#include <TD_SHT31Scheduler.h>
+
+/**
+ * ----------------------------------------------------------------------------
+ * Define SHT31, scheduler and variables.
+ * ----------------------------------------------------------------------------
+ */
+TD_SHT31 sht(0x44);
+TD_SHT31Scheduler scheduler;
+uint8_t cycles = 0;
+
+/**
+ * ----------------------------------------------------------------------------
+ * Result callback, called from scheduler.service().
+ * ----------------------------------------------------------------------------
+*/
+void onResult(uint8_t index, const TD_SHT31Measurement *result)
+{
+  Serial.print("Sensor ");
+  Serial.print(index);
+  if (result->ok() == false)
+  {
+    Serial.print(" error: 0b");
+    Serial.println(result->status, BIN);
+    return;
+  }
+  Serial.print(" at ");
+  Serial.print(result->timestamp);
+  Serial.print(" ms: ");
+  Serial.print(result->temperature * 0.01f);
+  Serial.print(" C, ");
+  Serial.print(result->humidity * 0.01f);
+  Serial.println(" %RH");
+
+  if (++cycles >= 10)
+  {
+    TD_SHT31Jitter jitter;
+    scheduler.getJitter(&jitter, true);
+    Serial.print("Jitter us min/mean/max: ");
+    Serial.print(jitter.min);
+    Serial.print("/");
+    Serial.print(jitter.mean);
+    Serial.print("/");
+    Serial.print(jitter.max);
+    Serial.print(", overruns: ");
+    Serial.println(jitter.overruns);
+    cycles = 0;
+  }
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * Setup
+ * ----------------------------------------------------------------------------
+*/
+void setup() {
+  /* Initialize serial port */
+  Serial.begin(9600);
+  while (!Serial) {
+    ; // Wait for serial port. Remove wait if not native USB port.
+  }
+  delay(1000);
+  Serial.println(" ");
+
+  sht.set_defaults(ENABLE_CRC, CELSIUS);
+  if (sht.begin() == false)
+  {
+    Serial.print("Error in begin(): 0b");
+    Serial.println(sht.getLastError(), BIN);
+    while (true) { ; }
+  }
+  sht.setAdaptiveTiming(true);
+
+  scheduler.addSensor(&sht, CMD_SS_CSD_HIGH);
+  scheduler.setCallback(onResult);
+  scheduler.setPeriod(5000000UL);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * Main loop. Other work may run here, it only delays the next service call.
+ * ----------------------------------------------------------------------------
+*/
+void loop() {
+  scheduler.service();
+}
@@ -1,330 +1,1735 @@
-/**
- * ----------------------------------------------------------------------------
- * @file TD_SHT31.cpp
- * @brief Arduino I2C library for SENSIRION SHT31 sensor (temperature & humidity).
- * @details Written by Honee52 for Technode Design (info@technode.fi).
- * You may use this library as it is or change it without limitations. 
- * Current version supports only sigle shot commands without stretching.
- * Beerware license.
- * @version 1.0.0
- * @note 'Simple is beatiful'
- * @todo Single shot commands with stretching and periodic commands.
- * Version history:
- * Version 1.0.0    Initial version
- * Version 1.0.1    Minor code changes.
- * ----------------------------------------------------------------------------
-*/
-
-#include "TD_SHT31.h"
-
-/**
- * ----------------------------------------------------------------------------
- * @brief Initialize TD_SHT31 Class.
- * ----------------------------------------------------------------------------
-*/
-TD_SHT31::TD_SHT31(uint8_t i2c_device_address)
-{
-    _i2c_device_address = i2c_device_address;
-    _useCRC     = ENABLE_CRC;
-    _tUnit      = CELSIUS;      
-    _error_code = NO_ERROR;
-}
-
-/**
- * ----------------------------------------------------------------------------
- * @brief Functions bool begin().
- * ----------------------------------------------------------------------------
-*/
-bool TD_SHT31::begin()
-{
-     return begin(&Wire);
-}
-
-bool TD_SHT31::begin(TwoWire *wire)
-{
-    _i2c = wire;
-    _i2c->begin();
-    _i2c->setClock(100000); // 100kHz
-    return resetSensor(CMD_GCALL_RESET);
-}
-
-/**
- * ----------------------------------------------------------------------------
- * @brief Function bool isSensorConnected().
- * @details Check if sensor is connected.
- * ----------------------------------------------------------------------------
-*/
-bool TD_SHT31::isSensorConnected()
-{
-    _i2c->beginTransmission(_i2c_device_address);
-    int retval = _i2c->endTransmission();
-    if (retval != 0)
-    { 
-        _error_code |= ERROR_END_TRANSMISSION;
-        return false;
-    }
-    return true;
-}
-
-/**
- * ----------------------------------------------------------------------------
- * @brief Functions void set_defaults(bool useCRC, bool tUnit).
- * ----------------------------------------------------------------------------
-*/
-void TD_SHT31::set_defaults(bool useCRC, bool tUnit)
-{
-    _useCRC = useCRC;
-    _tUnit = tUnit;
-}
-
-void TD_SHT31::set_defaults(bool useCRC, bool tUnit, uint8_t dataPIN, uint8_t clockPIN)
-{
-    _useCRC = useCRC;
-    _tUnit = tUnit;   
-    #if defined(ESP8266) || defined(ESP32)
-    Wire.setPins(dataPIN,clockPIN);
-    #endif
-}
-
-/**
- * ----------------------------------------------------------------------------
- * @brief Function bool resetSensor(uint16_t command).
- * @details Allowed commands CMD_SOFT_RESET or CMD_GCALL_RESET.
- * ----------------------------------------------------------------------------
-*/
-bool TD_SHT31::resetSensor(uint16_t command)
-{
-    byte buffer[2];
-    buffer[0] = command >> 8;
-    buffer[1] = command & 0xFF;
-    //    
-    if ((command != CMD_SOFT_RESET) && \
-        (command != CMD_GCALL_RESET))
-    {
-        _error_code |= ERROR_WRONG_COMMAND;
-        return false;
-    }
-    //
-    _i2c->beginTransmission(_i2c_device_address);
-    if (_i2c->write(buffer, 2) != 0x02)
-    {
-        _error_code |= ERROR_WRITE_LEN;
-    }
-    _i2c->endTransmission();    /* Dummy call */
-    if (_i2c->endTransmission() != 0)
-    {
-        _error_code |= ERROR_END_TRANSMISSION;
-        return false;
-    }
-    return true;    
-}
-
-/**
- * ----------------------------------------------------------------------------
- * @brief Function bool runSingleShot(uint16_t u16Command, float *fT, float *fH).
- * @details Calls runSingleShot(u16Command).
- * ----------------------------------------------------------------------------
-*/
-bool TD_SHT31::runSingleShot(uint16_t u16Command, float *fT, float *fH)
-{
-    uint8_t u8Delay;
-
-    if ((u16Command != CMD_SS_CSD_HIGH) && \
-        (u16Command != CMD_SS_CSD_MEDIUM) && \
-        (u16Command != CMD_SS_CSD_LOW))
-    {
-        _error_code |= ERROR_WRONG_COMMAND;
-        return false;        
-    }
-
-    if (writeCommand(u16Command) == false)
-    {
-        return false;
-    }
-    switch (u16Command)
-    {
-        /* Refer datasheet page 7 */
-        case CMD_SS_CSD_HIGH:   { u8Delay = 16; break; }
-        case CMD_SS_CSD_MEDIUM: { u8Delay = 7;  break; }
-        case CMD_SS_CSD_LOW:    { u8Delay = 5;  break; }
-        default:                { u8Delay = 16;}
-    }  
-    delay(u8Delay);
-
-    if(readSensorData())
-    {
-        *fT = _temperature;
-        *fH = _humidity;
-        return true;        
-    }
-    return false;
-}
-
-/**
- * ----------------------------------------------------------------------------
- * @brief Function bool clearSensorStatus().
- * ----------------------------------------------------------------------------
-*/
-bool TD_SHT31::clearSensorStatus()
-{   
-    if (writeCommand(CMD_CLEAR_STATUS) == false)
-    {
-        return 0xFFFF;
-    }
-    return true;
-}
-
-/**
- * ----------------------------------------------------------------------------
- * @brief Function uint16_t readSensorStatus().
- * ----------------------------------------------------------------------------
-*/
-uint16_t TD_SHT31::readSensorStatus()
-{
-    uint8_t buffer[3] = { 0, 0, 0 };
-    
-    if (writeCommand(CMD_READ_STATUS) == false)
-    {
-        return 0xFFFF;
-    }
-    
-    /* Read status bytes */
-    if (readBytes((uint8_t*) &buffer[0], 3) == false)
-    {
-        return 0xFFFF;
-    }
-
-    /* CRC  */
-    if (buffer[2] != crc8(buffer, 2)) 
-    {
-        _error_code |= ERROR_CRC_CHECK;
-        return 0xFFFF;
-    }
-
-    return (uint16_t) (buffer[0] << 8) + buffer[1];
-}
-
-/**
- * ----------------------------------------------------------------------------
- * @brief Function int getLastError().
- * ----------------------------------------------------------------------------
-*/
-int TD_SHT31::getLastError()
-{
-  int retval = _error_code;
-  _error_code = NO_ERROR;
-  return retval;
-}
-
-/**
- * ----------------------------------------------------------------------------
- * @brief Function bool readBytes(uint8_t *buffer, uint8_t len).
- * ----------------------------------------------------------------------------
-*/
-bool TD_SHT31::readBytes(uint8_t *buffer, uint8_t len)
-{
-    int retval = _i2c->requestFrom(_i2c_device_address, (uint8_t) len);
-    if (retval == len)
-    {
-        for (uint8_t i = 0; i < len; i++)
-        {
-            buffer[i] = _i2c->read();
-        }
-        return true;
-    }
-    _error_code |= ERROR_REQUEST_LEN;
-    return false;
-}
-
-/**
- * ----------------------------------------------------------------------------
- * @brief Function bool readSensorData().
- * @details
- * - Read from sendor.
- * - Make CRC-check if enabled.
- * - Calculate temperature and humidity values and save to _temperature and
- * - _humidity.
- * ----------------------------------------------------------------------------
-*/
-bool TD_SHT31::readSensorData()
-{
-    uint8_t buffer[6];
-    if (readBytes((uint8_t*) &buffer[0], 6) == false)
-    {
-        return false;
-    }
-
-    if (_useCRC)
-    {
-        if (buffer[2] != crc8(buffer, 2)) 
-        {
-            _error_code |= ERROR_CRC_CHECK;
-            return false;
-        }
-        if (buffer[5] != crc8(buffer + 3, 2)) 
-        {
-            _error_code |= ERROR_CRC_CHECK;
-            return false;
-        }
-    }
-
-    /* Conversion formulas - refer datasheet page 14 */
-     uint16_t data = (buffer[0] << 8) + buffer[1];
-    if (_tUnit)
-    {
-        _temperature = data * (175.0 / 65535) - 45; // Celsius
-    } else
-    {
-        _temperature = data * (315.0 / 65535) - 49; // Farenheit
-    }
-    data = (buffer[3] << 8) + buffer[4];
-    _humidity = data * (100.0 / 65535);
-
-    return true;
-}
-
-/**
- * ----------------------------------------------------------------------------
- *  @brief Function bool writeCommand(uint16_t command).
- * ----------------------------------------------------------------------------
-*/
-bool TD_SHT31::writeCommand(uint16_t command)
-{
-    byte buffer[2];
-    buffer[0] = command >> 8;
-    buffer[1] = command & 0xFF;
-    _i2c->beginTransmission(_i2c_device_address);
-    if (_i2c->write(buffer, 2) != 0x02)
-    {
-        _error_code |= ERROR_WRITE_LEN;
-        return false;
-    }
-    if (_i2c->endTransmission() != 0)
-    {
-        _error_code |= ERROR_END_TRANSMISSION;
-        return false;
-    }
-    return true;
-}
-
-/**
- * ----------------------------------------------------------------------------
- * @brief Function uint8_t crc8(const uint8_t *data, uint8_t len).
- * @details Calculate CRC - refer datasheet page 14.
- * ----------------------------------------------------------------------------
-*/
-uint8_t TD_SHT31::crc8(const uint8_t *data, uint8_t len) 
-{
-    const uint8_t POLY(0x31);
-    uint8_t crc(0xFF);
-
-    for (uint8_t j = len; j; --j) 
-    {
-        crc ^= *data++;
-        for (uint8_t i = 8; i; --i) 
-        {
-            crc = (crc & 0x80) ? (crc << 1) ^ POLY : (crc << 1);
-        }
-    }
-    return crc;
-}
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31.cpp
+ * @brief Arduino I2C library for SENSIRION SHT31 sensor (temperature & humidity).
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations. 
+ * Current version supports sigle shot commands with and without
+ * stretching and periodic commands including ART.
+ * Beerware license.
+ * @version 1.0.0
+ * @note 'Simple is beatiful'
+ * Version history:
+ * Version 1.0.0    Initial version
+ * Version 1.0.1    Minor code changes.
+ * ----------------------------------------------------------------------------
+*/
+
+#include "TD_SHT31.h"
+#include "TD_SHT31Transport.h"
+#include "TD_SHT31Lock.h"
+
+/**
+ * @brief Periodic commands indexed by [rate][repeatability].
+*/
+static const uint16_t PERIODIC_COMMANDS[5][3] =
+{
+    { CMD_PER_05_HIGH, CMD_PER_05_MEDIUM, CMD_PER_05_LOW },
+    { CMD_PER_1_HIGH,  CMD_PER_1_MEDIUM,  CMD_PER_1_LOW  },
+    { CMD_PER_2_HIGH,  CMD_PER_2_MEDIUM,  CMD_PER_2_LOW  },
+    { CMD_PER_4_HIGH,  CMD_PER_4_MEDIUM,  CMD_PER_4_LOW  },
+    { CMD_PER_10_HIGH, CMD_PER_10_MEDIUM, CMD_PER_10_LOW }
+};
+
+/**
+ * @brief Operations waiting for instance transfer _xfer.
+*/
+#define XFER_STAGE_NONE     0
+#define XFER_STAGE_COMMAND  1       /* Single shot command */
+#define XFER_STAGE_READ     2       /* Single shot data */
+#define XFER_STAGE_FETCH    3       /* Periodic fetch command and data */
+#define XFER_STAGE_BLOCKING 4       /* queueTransfer */
+
+/**
+ * @brief CRC-8 lookup tables, polynomial 0x31.
+ * @details Entry n is n (CRC_TABLE) or n << 4 (CRC_NIBBLE) shifted through
+ * the bitwise algorithm 8 or 4 times. Tables are PROGMEM, so they are
+ * read with pgm_read_byte on every core (ESP8266 needs aligned access).
+*/
+#define CRC_READ(table, i)  pgm_read_byte(&table[i])
+
+#if TD_SHT31_CRC_METHOD == CRC_TABLE
+static const uint8_t CRC8_TABLE[256] PROGMEM =
+{
+    0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97,
+    0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E,
+    0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4,
+    0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F, 0x5C, 0x6D,
+    0x86, 0xB7, 0xE4, 0xD5, 0x42, 0x73, 0x20, 0x11,
+    0x3F, 0x0E, 0x5D, 0x6C, 0xFB, 0xCA, 0x99, 0xA8,
+    0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52,
+    0x7C, 0x4D, 0x1E, 0x2F, 0xB8, 0x89, 0xDA, 0xEB,
+    0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA,
+    0x84, 0xB5, 0xE6, 0xD7, 0x40, 0x71, 0x22, 0x13,
+    0x7E, 0x4F, 0x1C, 0x2D, 0xBA, 0x8B, 0xD8, 0xE9,
+    0xC7, 0xF6, 0xA5, 0x94, 0x03, 0x32, 0x61, 0x50,
+    0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C,
+    0x02, 0x33, 0x60, 0x51, 0xC6, 0xF7, 0xA4, 0x95,
+    0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F,
+    0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6,
+    0x7A, 0x4B, 0x18, 0x29, 0xBE, 0x8F, 0xDC, 0xED,
+    0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54,
+    0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC, 0x9F, 0xAE,
+    0x80, 0xB1, 0xE2, 0xD3, 0x44, 0x75, 0x26, 0x17,
+    0xFC, 0xCD, 0x9E, 0xAF, 0x38, 0x09, 0x5A, 0x6B,
+    0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2,
+    0xBF, 0x8E, 0xDD, 0xEC, 0x7B, 0x4A, 0x19, 0x28,
+    0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91,
+    0x47, 0x76, 0x25, 0x14, 0x83, 0xB2, 0xE1, 0xD0,
+    0xFE, 0xCF, 0x9C, 0xAD, 0x3A, 0x0B, 0x58, 0x69,
+    0x04, 0x35, 0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93,
+    0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A,
+    0xC1, 0xF0, 0xA3, 0x92, 0x05, 0x34, 0x67, 0x56,
+    0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF,
+    0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15,
+    0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC
+};
+#elif TD_SHT31_CRC_METHOD == CRC_NIBBLE
+static const uint8_t CRC8_TABLE[16] PROGMEM =
+{
+    0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97,
+    0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E
+};
+#endif
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Initialize TD_SHT31 Class.
+ * ----------------------------------------------------------------------------
+*/
+TD_SHT31::TD_SHT31(uint8_t i2c_device_address)
+{
+    _i2c_device_address = i2c_device_address;
+    _i2c        = NULL;
+    _transport  = NULL;
+    _busLock    = NULL;
+    _stats      = NULL;
+    _busTimeout = 0;
+    _clock      = I2C_CLOCK_100K;
+    #if defined(PIN_WIRE_SDA) && defined(PIN_WIRE_SCL)
+    _sdaPIN     = PIN_WIRE_SDA;
+    _slcPIN     = PIN_WIRE_SCL;
+    #else
+    _sdaPIN     = NO_PIN;
+    _slcPIN     = NO_PIN;
+    #endif
+    _retryAttempts = 1;
+    _retryBackoff  = 0;
+    _retryFlags    = RETRY_NONE;
+    _retryCount    = 0;
+    _recoveryCount = 0;
+    _busBytes      = 0;
+    _ssRepeat   = REPEAT_HIGH;
+    _ssRetries  = 0;
+    _ssWait     = 0;
+    _ssMax      = 0;
+    _ssStart    = 0;
+    _ssRead     = 0;
+    _xfer.state = XFER_IDLE;
+    _xfer.next  = NULL;
+    _xferStage  = XFER_STAGE_NONE;
+    _xferAttempt = 0;
+    _learned[REPEAT_HIGH]   = ADAPTIVE_INIT_HIGH_US;
+    _learned[REPEAT_MEDIUM] = ADAPTIVE_INIT_MEDIUM_US;
+    _learned[REPEAT_LOW]    = ADAPTIVE_INIT_LOW_US;
+    _useCRC     = ENABLE_CRC;
+    _tUnit      = CELSIUS;      
+    _cal.tOffset = 0;
+    _cal.tGain   = CAL_GAIN_ONE;
+    _cal.hOffset = 0;
+    _cal.hGain   = CAL_GAIN_ONE;
+    _calibrated  = false;
+    #if TD_SHT31_ERROR_POLICY != ERRORS_NONE
+    _error_code  = NO_ERROR;
+    #endif
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Functions bool begin().
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::begin()
+{
+     return begin(&Wire);
+}
+
+bool TD_SHT31::begin(TwoWire *wire)
+{
+    _i2c = wire;
+    lockBus();
+    _i2c->begin();
+    _i2c->setClock(_clock); // 100kHz by default
+    applyBusTimeout();
+    unlockBus();
+    return resetSensor(CMD_GCALL_RESET);
+}
+
+bool TD_SHT31::begin(TwoWire *wire, uint32_t u32Clock)
+{
+    _clock = u32Clock;
+    return begin(wire);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void setClock(uint32_t u32Clock).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::setClock(uint32_t u32Clock)
+{
+    _clock = u32Clock;
+    if (_i2c != NULL)
+    {
+        lockBus();
+        _i2c->setClock(_clock);
+        unlockBus();
+    }
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void setTransport(TD_SHT31Transport *transport).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::setTransport(TD_SHT31Transport *transport)
+{
+    _transport = transport;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void setBusLock(TD_SHT31Lock *lock).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::setBusLock(TD_SHT31Lock *lock)
+{
+    _busLock = lock;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool isSensorConnected().
+ * @details Check if sensor is connected.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::isSensorConnected()
+{
+    beginCall();
+    int retval;
+    lockBus();
+    if (_transport != NULL)
+    {
+        retval = queueTransfer(NULL, 0, NULL, 0);
+    } else
+    {
+        _i2c->beginTransmission(_i2c_device_address);
+        retval = _i2c->endTransmission();
+    }
+    countTransfer(0, 0, (retval != 0) ? ERROR_END_TRANSMISSION : NO_ERROR);
+    unlockBus();
+    if (retval != 0)
+    { 
+        setError(ERROR_END_TRANSMISSION);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Functions void set_defaults(bool useCRC, bool tUnit).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::set_defaults(bool useCRC, bool tUnit)
+{
+    _useCRC = useCRC;
+    _tUnit = tUnit;
+}
+
+void TD_SHT31::set_defaults(bool useCRC, bool tUnit, uint8_t dataPIN, uint8_t clockPIN)
+{
+    _useCRC = useCRC;
+    _tUnit = tUnit;   
+    _sdaPIN = dataPIN;
+    _slcPIN = clockPIN;
+    #if defined(ESP8266) || defined(ESP32)
+    Wire.setPins(dataPIN,clockPIN);
+    #endif
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void setAdaptiveTiming(bool enable).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::setAdaptiveTiming(bool enable)
+{
+    _adaptive = enable;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint16_t getConversionTime(uint8_t repeatability).
+ * ----------------------------------------------------------------------------
+*/
+uint16_t TD_SHT31::getConversionTime(uint8_t repeatability)
+{
+    if (repeatability > REPEAT_LOW)
+    {
+        return 0;
+    }
+    return _learned[repeatability];
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void setRetryPolicy(uint8_t maxAttempts, ...).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::setRetryPolicy(uint8_t maxAttempts, uint8_t backoff, uint8_t flags)
+{
+    _retryAttempts = (maxAttempts == 0) ? 1 : maxAttempts;
+    _retryBackoff  = backoff;
+    _retryFlags    = flags;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Functions uint16_t getRetryCount() and getRecoveryCount().
+ * ----------------------------------------------------------------------------
+*/
+uint16_t TD_SHT31::getRetryCount()
+{
+    return _retryCount;
+}
+
+uint16_t TD_SHT31::getRecoveryCount()
+{
+    return _recoveryCount;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint32_t getBusBytes().
+ * ----------------------------------------------------------------------------
+*/
+uint32_t TD_SHT31::getBusBytes()
+{
+    uint32_t retval = _busBytes;
+    _busBytes = 0;
+    return retval;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void setBusTimeout(uint32_t u32Timeout).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::setBusTimeout(uint32_t u32Timeout)
+{
+    _busTimeout = u32Timeout;
+    if (_i2c != NULL)
+    {
+        applyBusTimeout();
+    }
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Functions void setCalibration(...) and getCalibration(...).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::setCalibration(const TD_SHT31Calibration *cal)
+{
+    _cal = *cal;
+    _calibrated = (_cal.tOffset != 0) || (_cal.tGain != CAL_GAIN_ONE) || \
+                  (_cal.hOffset != 0) || (_cal.hGain != CAL_GAIN_ONE);
+}
+
+void TD_SHT31::getCalibration(TD_SHT31Calibration *cal)
+{
+    *cal = _cal;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool setTwoPointCalibration(bool humidity, ...).
+ * @details gain = (reference2 - reference1) / (measured2 - measured1)
+ * offset = reference1 - measured1 * gain
+ * Gain is rounded to nearest, offset uses the same rounding of
+ * measured1 * gain as function calibrate, so calibrate(measured1) equals
+ * reference1 exactly.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::setTwoPointCalibration(bool humidity, int16_t measured1,
+    int16_t reference1, int16_t measured2, int16_t reference2)
+{
+    /* Equal points give no slope */
+    if (measured1 == measured2)
+    {
+        return false;
+    }
+    int32_t dMeasured  = (int32_t) measured2 - measured1;
+    int32_t dReference = (int32_t) reference2 - reference1;
+    if (dMeasured < 0)
+    {
+        dMeasured  = -dMeasured;
+        dReference = -dReference;
+    }
+    if (dReference <= 0)
+    {
+        return false;
+    }
+    int32_t gain = (dReference * CAL_GAIN_ONE + dMeasured / 2) / dMeasured;
+    if ((gain <= 0) || (gain > 0xFFFF))
+    {
+        return false;
+    }
+    int32_t offset = reference1 - \
+        (((int32_t) measured1 * gain + (CAL_GAIN_ONE / 2)) >> 14);
+    if ((offset < -32768L) || (offset > 32767L))
+    {
+        return false;
+    }
+
+    TD_SHT31Calibration cal = _cal;
+    if (humidity)
+    {
+        cal.hGain   = (uint16_t) gain;
+        cal.hOffset = (int16_t) offset;
+    } else
+    {
+        cal.tGain   = (uint16_t) gain;
+        cal.tOffset = (int16_t) offset;
+    }
+    setCalibration(&cal);
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Functions bool loadCalibration(...) and saveCalibration(...).
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::loadCalibration(TD_SHT31CalibrationStore load)
+{
+    TD_SHT31Calibration cal;
+    if ((load == NULL) || (load(&cal) == false))
+    {
+        return false;
+    }
+    setCalibration(&cal);
+    return true;
+}
+
+bool TD_SHT31::saveCalibration(TD_SHT31CalibrationStore save)
+{
+    TD_SHT31Calibration cal = _cal;
+    if (save == NULL)
+    {
+        return false;
+    }
+    return save(&cal);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void setStatistics(TD_SHT31Statistics *stats).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::setStatistics(TD_SHT31Statistics *stats)
+{
+    _stats = stats;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool resetSensor(uint16_t command).
+ * @details Allowed commands CMD_SOFT_RESET or CMD_GCALL_RESET.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::resetSensor(uint16_t command)
+{
+    beginCall();
+    byte buffer[2];
+    buffer[0] = command >> 8;
+    buffer[1] = command & 0xFF;
+    //    
+    if ((command != CMD_SOFT_RESET) && \
+        (command != CMD_GCALL_RESET))
+    {
+        setError(ERROR_WRONG_COMMAND);
+        return false;
+    }
+    //
+    int reset;
+    int retval;
+    lockBus();
+    if (_transport != NULL)
+    {
+        reset  = queueTransfer(buffer, 2, NULL, 0);
+        retval = queueTransfer(NULL, 0, NULL, 0);   /* Dummy call */
+    } else
+    {
+        _i2c->beginTransmission(_i2c_device_address);
+        if (_i2c->write(buffer, 2) != 0x02)
+        {
+            setError(ERROR_WRITE_LEN);
+        }
+        reset  = _i2c->endTransmission();    /* Dummy call */
+        retval = _i2c->endTransmission();
+    }
+    countTransfer(2, 0, (reset != 0) ? ERROR_END_TRANSMISSION : NO_ERROR);
+    countTransfer(0, 0, (retval != 0) ? ERROR_END_TRANSMISSION : NO_ERROR);
+    unlockBus();
+    if (retval != 0)
+    {
+        setError(ERROR_END_TRANSMISSION);
+        return false;
+    }
+    return true;    
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Functions bool runSingleShot(uint16_t u16Command, ...).
+ * @details Blocking wrapper for startSingleShot and pollSingleShotRaw.
+ * Integer result is converted from raw ticks, float from integer result.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::runSingleShot(uint16_t u16Command, float *fT, float *fH)
+{
+    int16_t iT, iH;
+    if (runSingleShot(u16Command, &iT, &iH))
+    {
+        *fT = iT * 0.01f;
+        *fH = iH * 0.01f;
+        return true;
+    }
+    return false;
+}
+
+bool TD_SHT31::runSingleShot(uint16_t u16Command, int16_t *iT, int16_t *iH)
+{
+    uint16_t u16T, u16H;
+    if (runSingleShotRaw(u16Command, &u16T, &u16H))
+    {
+        convertData(u16T, u16H, iT, iH);
+        return true;
+    }
+    return false;
+}
+
+bool TD_SHT31::runSingleShotRaw(uint16_t u16Command, uint16_t *u16T, uint16_t *u16H)
+{
+    beginCall();
+    if (startSingleShot(u16Command) == false)
+    {
+        return false;
+    }
+    delay(_ssWait / 1000);
+    delayMicroseconds(_ssWait % 1000);
+
+    uint8_t state;
+    while ((state = pollSingleShotRaw(u16T, u16H)) == MEAS_PENDING)
+    {
+        yield();    /* Adaptive retry, queued transfer or early delay() */
+    }
+    return (state == MEAS_READY);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function TD_SHT31Measurement measure(uint16_t u16Command).
+ * @details Errors of this call are returned in status, _error_code is
+ * restored so getLastError keeps working.
+ * ----------------------------------------------------------------------------
+*/
+TD_SHT31Measurement TD_SHT31::measure(uint16_t u16Command)
+{
+    TD_SHT31Measurement result;
+    int savedError = getLastError();
+    bool success = runSingleShotRaw(u16Command,
+        &result.rawTemperature, &result.rawHumidity);
+    result.retries = _ssRetries;
+    completeMeasurement(&result, success, savedError);
+    return result;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool startSingleShot(uint16_t u16Command).
+ * @details Write command and save start time. Does not wait. On transport
+ * command is queued and start time is saved again when it is completed.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::startSingleShot(uint16_t u16Command)
+{
+    beginCall();
+    if ((u16Command != CMD_SS_CSD_HIGH) && \
+        (u16Command != CMD_SS_CSD_MEDIUM) && \
+        (u16Command != CMD_SS_CSD_LOW) && \
+        (u16Command != CMD_SS_CSE_HIGH) && \
+        (u16Command != CMD_SS_CSE_MEDIUM) && \
+        (u16Command != CMD_SS_CSE_LOW))
+    {
+        setError(ERROR_WRONG_COMMAND);
+        return false;        
+    }
+
+    /* Sensor accepts only fetch and break commands in periodic mode */
+    if (_mode != MODE_IDLE)
+    {
+        setError(ERROR_WRONG_COMMAND);
+        return false;
+    }
+
+    _ssActive = false;
+    if (_transport != NULL)
+    {
+        if (transferBusy())
+        {
+            setError(ERROR_WRONG_COMMAND);
+            return false;
+        }
+        uint8_t buffer[2];
+        buffer[0] = u16Command >> 8;
+        buffer[1] = u16Command & 0xFF;
+        lockBus();
+        submitTransfer(XFER_STAGE_COMMAND, buffer, 2, NULL, 0);
+        unlockBus();
+
+        /* Synchronous backend has completed it already */
+        int error;
+        if (transferDone(&error, true) && (error != NO_ERROR))
+        {
+            setError(error);
+            return false;
+        }
+    } else if (writeCommand(u16Command) == false)
+    {
+        return false;
+    }
+    _ssStart   = micros();
+    _ssMax     = (uint16_t) conversionTime(u16Command) * 1000;
+    _ssRepeat  = repeatability(u16Command);
+    _ssRetries = 0;
+    _ssWait    = _ssMax;
+    if (_adaptive && (_ssMax != 0))
+    {
+        _ssWait = _learned[_ssRepeat] + ADAPTIVE_MARGIN_US;
+        if (_ssWait > _ssMax)
+        {
+            _ssWait = _ssMax;
+        }
+    }
+    _ssActive = true;
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Functions uint8_t pollSingleShot(...).
+ * @details
+ * - Return MEAS_PENDING if conversion time has not elapsed.
+ * - Otherwise read sensor data and return MEAS_READY or MEAS_FAILED.
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TD_SHT31::pollSingleShot(float *fT, float *fH)
+{
+    int16_t iT, iH;
+    uint8_t state = pollSingleShot(&iT, &iH);
+    if (state == MEAS_READY)
+    {
+        *fT = iT * 0.01f;
+        *fH = iH * 0.01f;
+    }
+    return state;
+}
+
+uint8_t TD_SHT31::pollSingleShot(int16_t *iT, int16_t *iH)
+{
+    uint16_t u16T, u16H;
+    uint8_t state = pollSingleShotRaw(&u16T, &u16H);
+    if (state == MEAS_READY)
+    {
+        convertData(u16T, u16H, iT, iH);
+    }
+    return state;
+}
+
+uint8_t TD_SHT31::pollSingleShotRaw(uint16_t *u16T, uint16_t *u16H)
+{
+    beginCall();
+    if (_ssActive == false)
+    {
+        setError(ERROR_WRONG_COMMAND);
+        return MEAS_FAILED;
+    }
+    if (_transport != NULL)
+    {
+        return pollSingleShotQueued(u16T, u16H);
+    }
+
+    /* Unsigned subtraction handles micros() overflow */
+    uint32_t u32Elapsed = micros() - _ssStart;
+    if (u32Elapsed < _ssWait)
+    {
+        return MEAS_PENDING;
+    }
+
+    /* Adaptive: sensor NACKs while busy, retry until datasheet maximum */
+    uint8_t buffer[6];
+    if ((_ssWait < _ssMax) && (u32Elapsed < _ssMax))
+    {
+        if (tryReadBytes(buffer, 6) == false)
+        {
+            _ssRetries++;
+            /* Clamp in 32 bits, poll may come long after start */
+            uint32_t u32Next = u32Elapsed + ADAPTIVE_RETRY_US;
+            _ssWait = (u32Next < _ssMax) ? (uint16_t) u32Next : _ssMax;
+            return MEAS_PENDING;
+        }
+    } else if (readBytes(buffer, 6) == false)
+    {
+        _ssActive = false;
+        return MEAS_FAILED;
+    }
+
+    _ssActive = false;
+    return finishSingleShot(buffer, u32Elapsed, u16T, u16H);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t pollSingleShotQueued(uint16_t *u16T, ...).
+ * @details Same steps as pollSingleShotRaw, each transfer is submitted
+ * and collected by a later call:
+ * - Command queued: return MEAS_PENDING, restart time when completed.
+ * - Conversion time elapsed: queue read and return MEAS_PENDING.
+ * - Read completed: NACK in adaptive window waits ADAPTIVE_RETRY_US.
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TD_SHT31::pollSingleShotQueued(uint16_t *u16T, uint16_t *u16H)
+{
+    int error;
+    if (_xferStage == XFER_STAGE_COMMAND)
+    {
+        if (transferDone(&error, true) == false)
+        {
+            return MEAS_PENDING;
+        }
+        if (error != NO_ERROR)
+        {
+            _ssActive = false;
+            setError(error);
+            return MEAS_FAILED;
+        }
+        _ssStart = micros();    /* Conversion starts after command */
+    }
+
+    if (_xferStage == XFER_STAGE_READ)
+    {
+        bool window = (_ssWait < _ssMax) && (_ssRead < _ssMax);
+        if (transferDone(&error, (window == false)) == false)
+        {
+            return MEAS_PENDING;
+        }
+        if (error == NO_ERROR)
+        {
+            _ssActive = false;
+            return finishSingleShot(_xferData, _ssRead, u16T, u16H);
+        }
+        if (window == false)
+        {
+            _ssActive = false;
+            setError(error);
+            return MEAS_FAILED;
+        }
+        _ssRetries++;
+        uint32_t u32Next = _ssRead + ADAPTIVE_RETRY_US;
+        _ssWait = (u32Next < _ssMax) ? (uint16_t) u32Next : _ssMax;
+    }
+
+    /* Unsigned subtraction handles micros() overflow */
+    uint32_t u32Elapsed = micros() - _ssStart;
+    if (u32Elapsed < _ssWait)
+    {
+        return MEAS_PENDING;
+    }
+    _ssRead = u32Elapsed;
+    lockBus();
+    submitTransfer(XFER_STAGE_READ, NULL, 0, _xferData, 6);
+    unlockBus();
+    return MEAS_PENDING;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t finishSingleShot(const uint8_t *buffer, ...).
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TD_SHT31::finishSingleShot(const uint8_t *buffer, uint32_t u32Elapsed,
+                                   uint16_t *u16T, uint16_t *u16H)
+{
+    if (_adaptive && (_ssMax != 0))
+    {
+        learnConversionTime(u32Elapsed);
+    }
+    if (decodeSensorData(buffer, u16T, u16H))
+    {
+        return MEAS_READY;
+    }
+    return MEAS_FAILED;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t startMeasurement(uint16_t u16Command, ...).
+ * @details Errors of a failed start are returned in status as in function
+ * measure, with ERRORS_FULL errors raised before this call stay in
+ * _error_code.
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TD_SHT31::startMeasurement(uint16_t u16Command, TD_SHT31Measurement *result)
+{
+    int savedError = getLastError();
+    if (startSingleShot(u16Command))
+    {
+        #if TD_SHT31_ERROR_POLICY == ERRORS_FULL
+        _error_code |= savedError;
+        #endif
+        return MEAS_PENDING;
+    }
+    completeMeasurement(result, false, savedError);
+    return MEAS_FAILED;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t pollMeasurement(TD_SHT31Measurement *result).
+ * @details Errors of the completing call are returned in status as in
+ * function measure.
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TD_SHT31::pollMeasurement(TD_SHT31Measurement *result)
+{
+    int savedError = getLastError();
+    uint8_t state = pollSingleShotRaw(&result->rawTemperature, &result->rawHumidity);
+    if (state == MEAS_PENDING)
+    {
+        #if TD_SHT31_ERROR_POLICY == ERRORS_FULL
+        _error_code |= savedError;
+        #endif
+        return state;
+    }
+    result->retries = _ssRetries;
+    completeMeasurement(result, (state == MEAS_READY), savedError);
+    return state;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool startPeriodic(uint8_t rate, uint8_t repeatability).
+ * @details Sensor converts autonomously until stopPeriodic is called.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::startPeriodic(uint8_t rate, uint8_t repeatability)
+{
+    beginCall();
+    if ((rate > PER_RATE_10) || (repeatability > REPEAT_LOW))
+    {
+        setError(ERROR_WRONG_COMMAND);
+        return false;
+    }
+
+    if (_mode != MODE_IDLE)
+    {
+        if (stopPeriodic() == false)
+        {
+            return false;
+        }
+    }
+
+    _ssActive = false;
+    if (writeCommand(PERIODIC_COMMANDS[rate][repeatability]) == false)
+    {
+        return false;
+    }
+    _mode = MODE_PERIODIC;
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool enableART().
+ * @details ART command - refer datasheet page 12.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::enableART()
+{
+    beginCall();
+    if (_mode != MODE_IDLE)
+    {
+        if (stopPeriodic() == false)
+        {
+            return false;
+        }
+    }
+
+    _ssActive = false;
+    if (writeCommand(CMD_PER_ART) == false)
+    {
+        return false;
+    }
+    _mode = MODE_ART;
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t getMode().
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TD_SHT31::getMode()
+{
+    return _mode;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Functions bool fetchPeriodic(...).
+ * @details Single fetch command and 6-byte read, no conversion wait.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::fetchPeriodic(float *fT, float *fH)
+{
+    int16_t iT, iH;
+    if (fetchPeriodic(&iT, &iH))
+    {
+        *fT = iT * 0.01f;
+        *fH = iH * 0.01f;
+        return true;
+    }
+    return false;
+}
+
+bool TD_SHT31::fetchPeriodic(int16_t *iT, int16_t *iH)
+{
+    uint16_t u16T, u16H;
+    if (fetchPeriodicRaw(&u16T, &u16H))
+    {
+        convertData(u16T, u16H, iT, iH);
+        return true;
+    }
+    return false;
+}
+
+bool TD_SHT31::fetchPeriodicRaw(uint16_t *u16T, uint16_t *u16H)
+{
+    beginCall();
+    if (_mode == MODE_IDLE)
+    {
+        setError(ERROR_WRONG_COMMAND);
+        return false;
+    }
+
+    uint8_t buffer[6];
+    if (readCommand(CMD_PER_FETCH_DATA, buffer, 6) == false)
+    {
+        return false;
+    }
+    return decodeSensorData(buffer, u16T, u16H);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function TD_SHT31Measurement fetch().
+ * ----------------------------------------------------------------------------
+*/
+TD_SHT31Measurement TD_SHT31::fetch()
+{
+    TD_SHT31Measurement result;
+    int savedError = getLastError();
+    bool success = fetchPeriodicRaw(&result.rawTemperature, &result.rawHumidity);
+    result.retries = 0;
+    completeMeasurement(&result, success, savedError);
+    return result;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t pollFetch(TD_SHT31Measurement *result).
+ * @details On transport first call queues fetch command and 6-byte read
+ * as one transfer, following calls collect it. Errors are returned in
+ * status as in function fetch.
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TD_SHT31::pollFetch(TD_SHT31Measurement *result)
+{
+    int savedError = getLastError();
+    bool success = false;
+    if (_transport == NULL)
+    {
+        success = fetchPeriodicRaw(&result->rawTemperature, &result->rawHumidity);
+    } else if ((_xferStage != XFER_STAGE_FETCH) && (_mode == MODE_IDLE))
+    {
+        setError(ERROR_WRONG_COMMAND);
+    } else if ((_xferStage != XFER_STAGE_FETCH) && transferBusy())
+    {
+        setError(ERROR_WRONG_COMMAND);
+    } else
+    {
+        if (_xferStage != XFER_STAGE_FETCH)
+        {
+            uint8_t buffer[2];
+            buffer[0] = CMD_PER_FETCH_DATA >> 8;
+            buffer[1] = CMD_PER_FETCH_DATA & 0xFF;
+            lockBus();
+            submitTransfer(XFER_STAGE_FETCH, buffer, 2, _xferData, 6);
+            unlockBus();
+        }
+        int error;
+        if (transferDone(&error, true) == false)
+        {
+            #if TD_SHT31_ERROR_POLICY == ERRORS_FULL
+            _error_code |= savedError;
+            #endif
+            return MEAS_PENDING;
+        }
+        if (error != NO_ERROR)
+        {
+            setError(error);
+        } else
+        {
+            success = decodeSensorData(_xferData,
+                &result->rawTemperature, &result->rawHumidity);
+        }
+    }
+    result->retries = 0;
+    completeMeasurement(result, success, savedError);
+    return success ? MEAS_READY : MEAS_FAILED;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool stopPeriodic().
+ * @details Sensor needs 1 ms after break - refer datasheet page 11.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::stopPeriodic()
+{
+    beginCall();
+    if (writeCommand(CMD_PER_BREAK) == false)
+    {
+        return false;
+    }
+    _mode = MODE_IDLE;
+    delay(1);
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool clearSensorStatus().
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::clearSensorStatus()
+{   
+    beginCall();
+    if (writeCommand(CMD_CLEAR_STATUS) == false)
+    {
+        return 0xFFFF;
+    }
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint16_t readSensorStatus().
+ * ----------------------------------------------------------------------------
+*/
+uint16_t TD_SHT31::readSensorStatus()
+{
+    beginCall();
+    uint8_t buffer[3] = { 0, 0, 0 };
+    
+    /* Command and status bytes */
+    if (readCommand(CMD_READ_STATUS, buffer, 3) == false)
+    {
+        return 0xFFFF;
+    }
+
+    /* CRC  */
+    if (buffer[2] != crc8(buffer, 2)) 
+    {
+        setError(ERROR_CRC_CHECK);
+        return 0xFFFF;
+    }
+
+    return (uint16_t) (buffer[0] << 8) + buffer[1];
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function int getLastError().
+ * ----------------------------------------------------------------------------
+*/
+int TD_SHT31::getLastError()
+{
+  #if TD_SHT31_ERROR_POLICY != ERRORS_NONE
+  int retval = _error_code;
+  _error_code = NO_ERROR;
+  return retval;
+  #else
+  return NO_ERROR;
+  #endif
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool readBytes(uint8_t *buffer, uint8_t len).
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::readBytes(uint8_t *buffer, uint8_t len)
+{
+    for (uint8_t attempt = 1; ; attempt++)
+    {
+        if (tryReadBytes(buffer, len))
+        {
+            return true;
+        }
+        if (attempt >= _retryAttempts)
+        {
+            break;
+        }
+        prepareRetry(attempt, false);
+    }
+    setError(ERROR_REQUEST_LEN);
+    #if defined(WIRE_HAS_TIMEOUT)
+    if (_i2c->getWireTimeoutFlag())
+    {
+        setError(ERROR_FM_TIMEOUT);
+        _i2c->clearWireTimeoutFlag();
+    }
+    #endif
+    return false;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Functions void lockBus(), void unlockBus().
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::lockBus()
+{
+    if (_busLock != NULL)
+    {
+        _busLock->lock();
+    }
+}
+
+void TD_SHT31::unlockBus()
+{
+    if (_busLock != NULL)
+    {
+        _busLock->unlock();
+    }
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function int queueTransfer(...).
+ * @details Blocking calls wait with yield() until backend has completed
+ * _xfer. Result of queued operation is kept, its data is in _xferData.
+ * ----------------------------------------------------------------------------
+*/
+int TD_SHT31::queueTransfer(const uint8_t *wdata, uint8_t wlen, uint8_t *rdata, uint8_t rlen)
+{
+    uint8_t stage = _xferStage;
+    while ((stage != XFER_STAGE_NONE) && (_xfer.state != XFER_DONE))
+    {
+        yield();
+    }
+    int parked = _xfer.result;
+    submitTransfer(XFER_STAGE_BLOCKING, wdata, wlen, rdata, rlen);
+    while (_xfer.state != XFER_DONE)
+    {
+        yield();
+    }
+    int error = _xfer.result;
+    _xfer.result = parked;
+    _xferStage   = stage;
+    return error;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void submitTransfer(uint8_t stage, ...).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::submitTransfer(uint8_t stage, const uint8_t *wdata, uint8_t wlen,
+                              uint8_t *rdata, uint8_t rlen)
+{
+    _xferStage     = stage;
+    _xferAttempt   = 1;
+    _xfer.address  = _i2c_device_address;
+    _xfer.writeLen = wlen;
+    _xfer.readLen  = rlen;
+    for (uint8_t i = 0; i < wlen; i++)
+    {
+        _xfer.writeData[i] = wdata[i];
+    }
+    _xfer.readData = rdata;
+    _xfer.callback = NULL;
+    _xfer.context  = NULL;
+    _xfer.state    = XFER_IDLE;
+    _transport->submit(&_xfer);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool transferDone(int *error, bool retry).
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::transferDone(int *error, bool retry)
+{
+    if (_xfer.state != XFER_DONE)
+    {
+        return false;
+    }
+    *error = _xfer.result;
+    countTransfer(_xfer.writeLen, _xfer.readLen, *error);
+    if ((*error != NO_ERROR) && retry && (_xferAttempt < _retryAttempts))
+    {
+        _xferAttempt++;
+        _retryCount++;
+        _xfer.state = XFER_IDLE;
+        lockBus();
+        _transport->submit(&_xfer);
+        unlockBus();
+        return false;
+    }
+    _xferStage = XFER_STAGE_NONE;
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool transferBusy().
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::transferBusy()
+{
+    if (_xferStage == XFER_STAGE_NONE)
+    {
+        return false;
+    }
+    if (_xfer.state != XFER_DONE)
+    {
+        return true;
+    }
+    countTransfer(_xfer.writeLen, _xfer.readLen, _xfer.result);
+    _xferStage = XFER_STAGE_NONE;
+    return false;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool tryReadBytes(uint8_t *buffer, uint8_t len).
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::tryReadBytes(uint8_t *buffer, uint8_t len)
+{
+    bool success = false;
+    lockBus();
+    if (_transport != NULL)
+    {
+        success = (queueTransfer(NULL, 0, buffer, len) == NO_ERROR);
+    } else if (_i2c->requestFrom(_i2c_device_address, (uint8_t) len) == len)
+    {
+        for (uint8_t i = 0; i < len; i++)
+        {
+            buffer[i] = _i2c->read();
+        }
+        success = true;
+    }
+    countTransfer(0, len, success ? NO_ERROR : ERROR_REQUEST_LEN);
+    unlockBus();
+    return success;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool decodeSensorData(const uint8_t *buffer, ...).
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::decodeSensorData(const uint8_t *buffer, uint16_t *u16T, uint16_t *u16H)
+{
+    if (_useCRC)
+    {
+        if (buffer[2] != crc8(buffer, 2)) 
+        {
+            setError(ERROR_CRC_CHECK);
+            return false;
+        }
+        if (buffer[5] != crc8(buffer + 3, 2)) 
+        {
+            setError(ERROR_CRC_CHECK);
+            return false;
+        }
+    }
+
+    *u16T = ((uint16_t) buffer[0] << 8) + buffer[1];
+    *u16H = ((uint16_t) buffer[3] << 8) + buffer[4];
+    if (_stats != NULL)
+    {
+        int16_t iT, iH;
+        convertData(*u16T, *u16H, &iT, &iH);
+        _stats->add(iT, iH);
+    }
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void convertData(...).
+ * @details Convert raw ticks into 0.01 units using selected temperature unit.
+ * Calibration is applied in integer domain if set.
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::convertData(uint16_t u16T, uint16_t u16H, int16_t *iT, int16_t *iH)
+{
+    *iT = _tUnit ? ticksToCentiCelsius(u16T) : ticksToCentiFarenheit(u16T);
+    *iH = ticksToCentiHumidity(u16H);
+    if (_calibrated)
+    {
+        *iT = calibrate(*iT, _cal.tGain, _cal.tOffset);
+        *iH = calibrate(*iH, _cal.hGain, _cal.hOffset);
+    }
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function int16_t calibrate(int16_t value, uint16_t gain, ...).
+ * ----------------------------------------------------------------------------
+*/
+int16_t TD_SHT31::calibrate(int16_t value, uint16_t gain, int16_t offset)
+{
+    int32_t result = (((int32_t) value * gain + (CAL_GAIN_ONE / 2)) >> 14) + offset;
+    if (result > 32767L)
+    {
+        return 32767;
+    }
+    if (result < -32768L)
+    {
+        return -32768;
+    }
+    return (int16_t) result;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void completeMeasurement(...).
+ * @details
+ * - Set status from errors raised after getLastError in caller.
+ * - Restore _error_code (ERRORS_FULL), with ERRORS_LEAN it stays status of
+ *   this call.
+ * - Convert raw ticks if measurement succeeded, otherwise clear values and
+ *   retries.
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::completeMeasurement(TD_SHT31Measurement *result, bool success,
+                                   int savedError)
+{
+    #if TD_SHT31_ERROR_POLICY == ERRORS_FULL
+    result->status = (uint16_t) _error_code;
+    _error_code |= savedError;
+    #elif TD_SHT31_ERROR_POLICY == ERRORS_LEAN
+    (void) savedError;
+    result->status = _error_code;
+    #else
+    (void) savedError;
+    result->status = NO_ERROR;
+    #endif
+    if (success == false)
+    {
+        if (result->status == NO_ERROR)
+        {
+            result->status = ERROR_UNKNOWN;
+        }
+        result->rawTemperature = 0;
+        result->rawHumidity    = 0;
+        result->temperature    = 0;
+        result->humidity       = 0;
+        result->retries        = 0;
+        result->timestamp      = millis();
+        return;
+    }
+    convertData(result->rawTemperature, result->rawHumidity,
+                &result->temperature, &result->humidity);
+    result->timestamp = millis();
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void applyBusTimeout().
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::applyBusTimeout()
+{
+    if (_busTimeout == 0)
+    {
+        return;
+    }
+    #if defined(WIRE_HAS_TIMEOUT)
+    _i2c->setWireTimeout(_busTimeout, true);
+    #elif defined(ESP8266)
+    _i2c->setClockStretchLimit(_busTimeout);
+    #elif defined(ESP32)
+    _i2c->setTimeOut((uint16_t) ((_busTimeout + 999) / 1000));
+    #endif
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t conversionTime(uint16_t u16Command).
+ * @details Maximum measurement duration - refer datasheet page 7.
+ * With clock stretching sensor holds SCL, so no wait is needed.
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TD_SHT31::conversionTime(uint16_t u16Command)
+{
+    switch (u16Command)
+    {
+        case CMD_SS_CSE_HIGH:
+        case CMD_SS_CSE_MEDIUM:
+        case CMD_SS_CSE_LOW:    { return 0;  }
+        case CMD_SS_CSD_HIGH:   { return 16; }
+        case CMD_SS_CSD_MEDIUM: { return 7;  }
+        case CMD_SS_CSD_LOW:    { return 5;  }
+        default:                { return 16; }
+    }
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t repeatability(uint16_t u16Command).
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TD_SHT31::repeatability(uint16_t u16Command)
+{
+    switch (u16Command)
+    {
+        case CMD_SS_CSE_MEDIUM:
+        case CMD_SS_CSD_MEDIUM: { return REPEAT_MEDIUM; }
+        case CMD_SS_CSE_LOW:
+        case CMD_SS_CSD_LOW:    { return REPEAT_LOW;    }
+        default:                { return REPEAT_HIGH;   }
+    }
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void learnConversionTime(uint32_t u32Elapsed).
+ * @details
+ * - Read succeeded at first attempt: estimate may be too long, decrease
+ * - it by 1/16 to probe shorter times.
+ * - Read was NACKed before: sensor was ready between last NACK and
+ * - u32Elapsed, use u32Elapsed as new estimate.
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::learnConversionTime(uint32_t u32Elapsed)
+{
+    uint16_t u16Learned = _learned[_ssRepeat];
+    if (_ssRetries == 0)
+    {
+        u16Learned -= u16Learned >> 4;
+    } else
+    {
+        u16Learned = (u32Elapsed < _ssMax) ? (uint16_t) u32Elapsed : _ssMax;
+    }
+    if (u16Learned < ADAPTIVE_MIN_US)
+    {
+        u16Learned = ADAPTIVE_MIN_US;
+    }
+    _learned[_ssRepeat] = u16Learned;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ *  @brief Function bool writeCommand(uint16_t command).
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::writeCommand(uint16_t command)
+{
+    int error;
+    for (uint8_t attempt = 1; ; attempt++)
+    {
+        error = writeCommandOnce(command);
+        if (error == NO_ERROR)
+        {
+            return true;
+        }
+        if (attempt >= _retryAttempts)
+        {
+            break;
+        }
+        prepareRetry(attempt, (command != CMD_SOFT_RESET));
+    }
+    setError(error);
+    return false;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ *  @brief Function int writeCommandOnce(uint16_t command).
+ * ----------------------------------------------------------------------------
+*/
+int TD_SHT31::writeCommandOnce(uint16_t command)
+{
+    byte buffer[2];
+    buffer[0] = command >> 8;
+    buffer[1] = command & 0xFF;
+    int error = NO_ERROR;
+    lockBus();
+    if (_transport != NULL)
+    {
+        error = queueTransfer(buffer, 2, NULL, 0);
+    } else
+    {
+        _i2c->beginTransmission(_i2c_device_address);
+        if (_i2c->write(buffer, 2) != 0x02)
+        {
+            error = ERROR_WRITE_LEN;
+        } else if (_i2c->endTransmission() != 0)
+        {
+            error = ERROR_END_TRANSMISSION;
+        }
+    }
+    countTransfer(2, 0, error);
+    unlockBus();
+    return error;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ *  @brief Function bool readCommand(uint16_t command, uint8_t *buffer, ...).
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::readCommand(uint16_t command, uint8_t *buffer, uint8_t len)
+{
+    int error;
+    for (uint8_t attempt = 1; ; attempt++)
+    {
+        error = readCommandOnce(command, buffer, len);
+        if (error == NO_ERROR)
+        {
+            return true;
+        }
+        if (attempt >= _retryAttempts)
+        {
+            break;
+        }
+        prepareRetry(attempt, true);
+    }
+    setError(error);
+    #if defined(WIRE_HAS_TIMEOUT)
+    if (_i2c->getWireTimeoutFlag())
+    {
+        setError(ERROR_FM_TIMEOUT);
+        _i2c->clearWireTimeoutFlag();
+    }
+    #endif
+    return false;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ *  @brief Function int readCommandOnce(uint16_t command, uint8_t *buffer, ...).
+ *  @details Command write and read are one transaction with repeated start,
+ *  one transfer on transport or one I2C_RDWR ioctl on Linux.
+ * ----------------------------------------------------------------------------
+*/
+int TD_SHT31::readCommandOnce(uint16_t command, uint8_t *buffer, uint8_t len)
+{
+    byte cmd[2];
+    cmd[0] = command >> 8;
+    cmd[1] = command & 0xFF;
+    int error = NO_ERROR;
+    lockBus();
+    if (_transport != NULL)
+    {
+        error = queueTransfer(cmd, 2, buffer, len);
+    } else
+    {
+        _i2c->beginTransmission(_i2c_device_address);
+        if (_i2c->write(cmd, 2) != 0x02)
+        {
+            error = ERROR_WRITE_LEN;
+        } else if (_i2c->endTransmission(false) != 0)
+        {
+            error = ERROR_END_TRANSMISSION;
+        } else if (_i2c->requestFrom(_i2c_device_address, (uint8_t) len) != len)
+        {
+            error = ERROR_REQUEST_LEN;
+        } else
+        {
+            for (uint8_t i = 0; i < len; i++)
+            {
+                buffer[i] = _i2c->read();
+            }
+        }
+    }
+    countTransfer(2, len, error);
+    unlockBus();
+    return error;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ *  @brief Function void countTransfer(uint8_t wlen, uint8_t rlen, int error).
+ *  @details Address byte per start, data bytes only after address ACK.
+ *  Write buffer error sends nothing.
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::countTransfer(uint8_t wlen, uint8_t rlen, int error)
+{
+    if (error == ERROR_WRITE_LEN)
+    {
+        return;
+    }
+    if ((wlen != 0) || (rlen == 0))
+    {
+        if (error == ERROR_END_TRANSMISSION)
+        {
+            _busBytes += 1;
+            return;
+        }
+        _busBytes += 1 + (uint32_t) wlen;
+    }
+    if (rlen != 0)
+    {
+        _busBytes += (error == NO_ERROR) ? 1 + (uint32_t) rlen : 1;
+    }
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ *  @brief Function void prepareRetry(uint8_t attempt, bool allowReset).
+ *  @details Escalation:
+ *  - Attempt 1 failed: bus recovery (RETRY_BUS_RECOVERY).
+ *  - Attempt 2 failed: soft reset (RETRY_SOFT_RESET), only in idle mode.
+ *  - Every retry waits backoff * attempt milliseconds.
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31::prepareRetry(uint8_t attempt, bool allowReset)
+{
+    _retryCount++;
+    if ((attempt == 1) && (_retryFlags & RETRY_BUS_RECOVERY))
+    {
+        if (recoverBus())
+        {
+            _recoveryCount++;
+        }
+    }
+    if ((attempt == 2) && (_retryFlags & RETRY_SOFT_RESET) && \
+        allowReset && (_mode == MODE_IDLE))
+    {
+        if (writeCommandOnce(CMD_SOFT_RESET) == NO_ERROR)
+        {
+            _recoveryCount++;
+            delay(2);   /* Soft reset time 1.5 ms - refer datasheet page 7 */
+        }
+    }
+    delay((uint16_t) _retryBackoff * attempt);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ *  @brief Function bool recoverBus().
+ *  @details Slave holding SDA low is released by clocking SCL up to 9 times,
+ *  then STOP condition is generated. Open drain is emulated with
+ *  INPUT_PULLUP (high) and OUTPUT LOW (low).
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31::recoverBus()
+{
+    if ((_sdaPIN == NO_PIN) || (_slcPIN == NO_PIN))
+    {
+        return false;
+    }
+
+    lockBus();
+    /* Transfer of other transport user may be running */
+    while ((_transport != NULL) && (_transport->isIdle() == false))
+    {
+        yield();
+    }
+    #if defined(__AVR__) || defined(ESP32)
+    _i2c->end();
+    #endif
+
+    pinMode(_sdaPIN, INPUT_PULLUP);
+    pinMode(_slcPIN, INPUT_PULLUP);
+    for (uint8_t i = 0; (i < 9) && (digitalRead(_sdaPIN) == LOW); i++)
+    {
+        digitalWrite(_slcPIN, LOW);
+        pinMode(_slcPIN, OUTPUT);
+        delayMicroseconds(5);
+        pinMode(_slcPIN, INPUT_PULLUP);
+        delayMicroseconds(5);
+    }
+
+    /* STOP: SDA low to high while SCL high */
+    digitalWrite(_sdaPIN, LOW);
+    pinMode(_sdaPIN, OUTPUT);
+    delayMicroseconds(5);
+    pinMode(_sdaPIN, INPUT_PULLUP);
+    delayMicroseconds(5);
+
+    _i2c->begin();
+    _i2c->setClock(_clock);
+    applyBusTimeout();
+    unlockBus();
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t crc8(const uint8_t *data, uint8_t len).
+ * @details Calculate CRC - refer datasheet page 14.
+ * Method is selected with TD_SHT31_CRC_METHOD.
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TD_SHT31::crc8(const uint8_t *data, uint8_t len) 
+{
+    uint8_t crc(0xFF);
+
+#if TD_SHT31_CRC_METHOD == CRC_TABLE
+    for (uint8_t j = len; j; --j) 
+    {
+        crc = CRC_READ(CRC8_TABLE, crc ^ *data++);
+    }
+#elif TD_SHT31_CRC_METHOD == CRC_NIBBLE
+    for (uint8_t j = len; j; --j) 
+    {
+        crc ^= *data++;
+        crc = (crc << 4) ^ CRC_READ(CRC8_TABLE, crc >> 4);
+        crc = (crc << 4) ^ CRC_READ(CRC8_TABLE, crc >> 4);
+    }
+#else
+    const uint8_t POLY(0x31);
+
+    for (uint8_t j = len; j; --j) 
+    {
+        crc ^= *data++;
+        for (uint8_t i = 8; i; --i) 
+        {
+            crc = (crc & 0x80) ? (crc << 1) ^ POLY : (crc << 1);
+        }
+    }
+#endif
+    return crc;
+}
@@ -1,243 +1,1008 @@
-/**
- * ----------------------------------------------------------------------------
- * @file TD_SHT31.h
- * @brief Arduino I2C library for SENSIRION SHT31 sensor (temperature & humidity).
- * @details Written by Honee52 for Technode Design (info@technode.fi).
- * You may use this library as it is or change it without limitations. 
- * Current version supports only sigle shot commands without stretching.
- * Beerware license.
- * @version 1.0.0
- * @note 'Simple is beatiful'
- * @todo Single shot commands with stretching and periodic commands.
- * Version history:
- * Version 1.0.0    Initial version
- * ----------------------------------------------------------------------------
-*/
-#ifndef TD_SHT31_H
-#define TD_SHT31_H
-
-#if defined(ARDUINO) && ARDUINO >= 100
-#include "Wire.h"
-#include "Arduino.h"
-#else
-#include "WProgram.h"
-#endif
-
-#define TD_SHT31_VERSION "1.0.0"
-
-/**
- * @brief Commands.
-*/
-
-/** @brief Single shot (SS) commands, clock stretching enabled (CSE). */
-/** @note: TwoWire class does not support stretching. */
-#define CMD_SS_CSE_HIGH     0x2C06
-#define CMD_SS_CSE_MEDIUM   0x2C0D
-#define CMD_SS_CSE_LOW      0x2C10
-
-/** @brief Single shot (SS) commands, clock stretching disabled (CSD). */
-#define CMD_SS_CSD_HIGH     0x2400
-#define CMD_SS_CSD_MEDIUM   0x240B
-#define CMD_SS_CSD_LOW      0x2416
-
-/** @brief Periodic commands 0.5/12/4/10 mps. */
-#define CMD_PER_05_HIGH     0x2032
-#define CMD_PER_05_MEDIUM   0x2024
-#define CMD_PER_05_LOW      0x202F
-
-#define CMD_PER_1_HIGH      0x2130
-#define CMD_PER_1_MEDIUM    0x2126
-#define CMD_PER_1_LOW       0x212D
-
-#define CMD_PER_2_HIGH      0x2236
-#define CMD_PER_2_MEDIUM    0x2220
-#define CMD_PER_2_LOW       0x222B
-
-#define CMD_PER_4_HIGH      0x2334
-#define CMD_PER_4_MEDIUM    0x2322
-#define CMD_PER_4_LOW       0x2329
-
-#define CMD_PER_10_HIGH     0x2737
-#define CMD_PER_10_MEDIUM   0x2721
-#define CMD_PER_10_LOW      0x272A
-
-/** @brief Fetch Data.  */
-#define CMD_PER_FETCH_DATA  0xE000
-
-/** @brief ART (accelerated  response  time). */
-#define CMD_PER_ART         0x2B32
-
-/** @brief Break. */
-#define CMD_PER_BREAK       0x3093
-
-/** @brief Soft reset & General call reset. */
-#define CMD_SOFT_RESET      0x30A2
-#define CMD_GCALL_RESET     0x0006
-
-/* Heater enable/diable. */
-#define CMD_HEATER_ON       0x306D
-#define CMD_HEATER_OFF      0x3066
-
-/** @brief Status register. */
-#define CMD_READ_STATUS     0xF32D
-#define CMD_CLEAR_STATUS    0x3041
-
-/**
- * @brief Some definitions.
- * @details Used in function set_defaults.
-*/
-#define ENABLE_CRC          true
-#define DISABLE_CRC         false
-#define CELSIUS             true
-#define FARENHEIT           false
-
-/**
- * @brief Error codes & error masks.
-*/
-#define NO_ERROR                    0b0000000000000000
-#define ERROR_TRANSMISSION_LEN      0b0000000000000001
-#define ERROR_END_TRANSMISSION      0b0000000000000010
-#define ERROR_REQUEST_LEN           0b0000000000000100
-#define ERROR_WRITE_LEN             0b0000000000001000
-#define ERROR_WRONG_SENSOR_ID       0b0000000000010000
-#define ERROR_FM_TIMEOUT            0b0000000000100000
-#define ERROR_NOT_CONNECTED         0b0000000001000000
-#define ERROR_CRC_CHECK             0b0000000010000000
-#define ERROR_WRONG_COMMAND         0b0000000100000001
-
-/**
- * @class TD_SHT31.
- * @brief TD_SHT31 Class definition.
-*/
-class TD_SHT31
-{
-    public:
-    /**
-     * @brief TD_SHT31 Class forward declaration.
-     * @param[in] I2C address of the SHT31 device
-    */
-    TD_SHT31(uint8_t i2c_device_address);
-
-    /**
-     * @brief Function begin.
-     * @return boolean result
-    */
-    bool begin();
-
-    /**
-     * @brief Function begin.
-     * @param *wire
-     * @return boolean result
-    */    
-    bool begin(TwoWire *wire);
-
-    /**
-     * @brief Check if sensor is connected.
-     * @return boolean result
-    */
-    bool isSensorConnected();   
-
-    /**
-     * @brief Set enable/disable crc and temperature unit. 
-     * @param useCRC (ENABLE_CRC or DISABLE_CRC)
-     * @param tUnit temperature unit (CELSIUS or FARENHEITH)
-     * @return void
-    */
-    void set_defaults(bool useCRC, bool tUnit); 
-
-     /**
-     * @brief Set enable/disable crc, temperature unit, SDA-pin and SLC-pin. 
-     * @param useCRC (ENABLE_CRC or DISABLE_CRC)
-     * @param tUnit temperature unit (CELSIUS or FARENHEITH)
-     * @param dataPIN I2C SDA-pin (only ESP8266 or ESP32)
-     * @param clockPIN I2C SCL-pin (only ESP8266 or ESP32)
-     * @return void
-    */   
-    void set_defaults(bool useCRC, bool tUnit, uint8_t dataPIN, uint8_t clockPIN);     
-
-    /**
-     * @brief Reset sensor
-     * @param command
-     * @return boolean result
-     * @note Only commands CMD_SOFT_RESET or CMD_GCALL_RESET are allowed.
-    */
-    bool resetSensor(uint16_t command);
-
-    /**
-     * @brief Execute single shot measurement.
-     * @param u16Command
-     * @param *fT [out] float *temperature
-     * @param *fH [out] float *humidity
-     * @return boolean result
-    */    
-    bool runSingleShot(uint16_t u16Command, float *fT, float *fH);
-
-    /**
-     * @brief Clear sensor status.
-     * @param void
-     * @return boolean result
-    */
-    bool clearSensorStatus();
-
-    /**
-     * @brief Read sensor status.
-     * @param void
-     * @return Sensor status
-     * @note If function fails to read status, value 0xFFFF is returned.
-    */
-    uint16_t readSensorStatus();    
-    
-    /**
-     * @brief Return last error.
-     * @param void
-     * @return error code (_error_code)
-     * @note When reading _error_code is cleared.
-    */
-    int getLastError();
-
-    /**
-     * @brief TD_SHT31 Class private declarations.
-    */
-    private:  
-    TwoWire* _i2c;
-    uint8_t _sdaPIN;
-    uint8_t _slcPIN;
-    uint8_t _i2c_device_address;
-    int _error_code;
-    float _humidity;
-    float _temperature;
-    bool _useCRC = ENABLE_CRC;
-    bool _tUnit = CELSIUS;   
-
-    /**
-     * @brief Read bytes to buffer.
-     * @param *buffer [out] data buffer
-     * @param data length (len)
-     * @return boolean result
-    */
-    bool readBytes(uint8_t *buffer, uint8_t len);
-
-    /**
-     * @brief Read sensor data into _temperature and _humidity.
-     * @param void
-     * @return boolean result
-    */    
-    bool readSensorData();
-
-    /**
-     * @brief Write command to sensor.
-     * @param command
-     * @return boolean result
-    */
-    bool writeCommand(uint16_t command);
-
-    /**
-     * @brief Calculate checksum.
-     * @param *data [in] data buffer
-     * @param len data length (len)
-     * @return CRC (uint8_t)
-    */
-    uint8_t crc8(const uint8_t *data, uint8_t len);
-};
-
-#endif  //TD_SHT31_H
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31.h
+ * @brief Arduino I2C library for SENSIRION SHT31 sensor (temperature & humidity).
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations. 
+ * Current version supports sigle shot commands with and without
+ * stretching and periodic commands including ART.
+ * Beerware license.
+ * @version 1.0.0
+ * @note 'Simple is beatiful'
+ * Version history:
+ * Version 1.0.0    Initial version
+ * ----------------------------------------------------------------------------
+*/
+#ifndef TD_SHT31_H
+#define TD_SHT31_H
+
+#if defined(TD_SHT31_LINUX)
+#include "TD_SHT31Linux.h"
+#elif defined(ARDUINO) && ARDUINO >= 100
+#include "Wire.h"
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+#include "TD_SHT31RingBuffer.h"
+#include "TD_SHT31Transfer.h"
+#include "TD_SHT31Statistics.h"
+
+#define TD_SHT31_VERSION "1.0.0"
+
+/**
+ * @brief Commands.
+*/
+
+/** @brief Single shot (SS) commands, clock stretching enabled (CSE). */
+/** @note: Sensor holds SCL until data is ready, see setBusTimeout. */
+#define CMD_SS_CSE_HIGH     0x2C06
+#define CMD_SS_CSE_MEDIUM   0x2C0D
+#define CMD_SS_CSE_LOW      0x2C10
+
+/** @brief Single shot (SS) commands, clock stretching disabled (CSD). */
+#define CMD_SS_CSD_HIGH     0x2400
+#define CMD_SS_CSD_MEDIUM   0x240B
+#define CMD_SS_CSD_LOW      0x2416
+
+/** @brief Periodic commands 0.5/12/4/10 mps. */
+#define CMD_PER_05_HIGH     0x2032
+#define CMD_PER_05_MEDIUM   0x2024
+#define CMD_PER_05_LOW      0x202F
+
+#define CMD_PER_1_HIGH      0x2130
+#define CMD_PER_1_MEDIUM    0x2126
+#define CMD_PER_1_LOW       0x212D
+
+#define CMD_PER_2_HIGH      0x2236
+#define CMD_PER_2_MEDIUM    0x2220
+#define CMD_PER_2_LOW       0x222B
+
+#define CMD_PER_4_HIGH      0x2334
+#define CMD_PER_4_MEDIUM    0x2322
+#define CMD_PER_4_LOW       0x2329
+
+#define CMD_PER_10_HIGH     0x2737
+#define CMD_PER_10_MEDIUM   0x2721
+#define CMD_PER_10_LOW      0x272A
+
+/** @brief Fetch Data.  */
+#define CMD_PER_FETCH_DATA  0xE000
+
+/** @brief ART (accelerated  response  time). */
+#define CMD_PER_ART         0x2B32
+
+/** @brief Break. */
+#define CMD_PER_BREAK       0x3093
+
+/** @brief Soft reset & General call reset. */
+#define CMD_SOFT_RESET      0x30A2
+#define CMD_GCALL_RESET     0x0006
+
+/* Heater enable/diable. */
+#define CMD_HEATER_ON       0x306D
+#define CMD_HEATER_OFF      0x3066
+
+/** @brief Status register. */
+#define CMD_READ_STATUS     0xF32D
+#define CMD_CLEAR_STATUS    0x3041
+
+/**
+ * @brief Some definitions.
+ * @details Used in function set_defaults.
+*/
+#define ENABLE_CRC          true
+#define DISABLE_CRC         false
+#define CELSIUS             true
+#define FARENHEIT           false
+
+/**
+ * @brief CRC calculation methods.
+ * @details Select with build flag, e.g. -DTD_SHT31_CRC_METHOD=CRC_TABLE.
+ * Define in sketch does not reach library source.
+ * - CRC_BITWISE: no table, 8 shift steps per byte.
+ * - CRC_NIBBLE:  16 byte table, 2 lookups per byte (default).
+ * - CRC_TABLE:   256 byte table (PROGMEM), 1 lookup per byte.
+*/
+#define CRC_BITWISE         0
+#define CRC_NIBBLE          1
+#define CRC_TABLE           2
+
+#ifndef TD_SHT31_CRC_METHOD
+#define TD_SHT31_CRC_METHOD CRC_NIBBLE
+#endif
+
+/**
+ * @brief I2C clock frequencies.
+ * @details Used in functions begin and setClock. SHT31 supports up to
+ * 1 MHz (Fast-Mode Plus), TwoWire implementation may limit the maximum.
+*/
+#define I2C_CLOCK_100K      100000
+#define I2C_CLOCK_400K      400000
+#define I2C_CLOCK_1M        1000000
+
+/**
+ * @brief Periodic measurement rates (mps) and repeatability.
+ * @details Used in function startPeriodic.
+*/
+#define PER_RATE_05         0
+#define PER_RATE_1          1
+#define PER_RATE_2          2
+#define PER_RATE_4          3
+#define PER_RATE_10         4
+
+#define REPEAT_HIGH         0
+#define REPEAT_MEDIUM       1
+#define REPEAT_LOW          2
+
+/**
+ * @brief Measurement modes.
+ * @details Returned by function getMode.
+*/
+#define MODE_IDLE           0
+#define MODE_PERIODIC       1
+#define MODE_ART            2
+
+/**
+ * @brief Adaptive conversion timing.
+ * @details Used in function setAdaptiveTiming. Times in microseconds.
+ * Initial estimates are typical durations - refer datasheet page 7.
+*/
+#define ADAPTIVE_MARGIN_US      250
+#define ADAPTIVE_RETRY_US       250
+#define ADAPTIVE_MIN_US         1000
+#define ADAPTIVE_INIT_HIGH_US   12500
+#define ADAPTIVE_INIT_MEDIUM_US 4500
+#define ADAPTIVE_INIT_LOW_US    2500
+
+/**
+ * @brief Error codes & error masks.
+*/
+#define NO_ERROR                    0b0000000000000000
+#define ERROR_TRANSMISSION_LEN      0b0000000000000001
+#define ERROR_END_TRANSMISSION      0b0000000000000010
+#define ERROR_REQUEST_LEN           0b0000000000000100
+#define ERROR_WRITE_LEN             0b0000000000001000
+#define ERROR_WRONG_SENSOR_ID       0b0000000000010000
+#define ERROR_FM_TIMEOUT            0b0000000000100000
+#define ERROR_NOT_CONNECTED         0b0000000001000000
+#define ERROR_CRC_CHECK             0b0000000010000000
+#define ERROR_WRONG_COMMAND         0b0000000100000000
+#define ERROR_BUFFER_FULL           0b0000001000000000
+#define ERROR_UNKNOWN               0b0000010000000000
+
+/**
+ * @brief Error accounting policies.
+ * @details Select with build flag, e.g. -DTD_SHT31_ERROR_POLICY=ERRORS_LEAN,
+ * so that library source and sketch use the same policy. Define in sketch
+ * does not reach library source, and class layout depends on policy.
+ * - ERRORS_FULL: error bits are accumulated until getLastError (default).
+ * - ERRORS_LEAN: 16-bit status of latest call, cleared when a call starts,
+ *   no read-modify-write. getLastError and status of measurement results
+ *   report only that call.
+ * - ERRORS_NONE: no error tracking, _error_code is compiled out and
+ *   getLastError returns NO_ERROR.
+*/
+#define ERRORS_FULL         0
+#define ERRORS_LEAN         1
+#define ERRORS_NONE         2
+
+#ifndef TD_SHT31_ERROR_POLICY
+#define TD_SHT31_ERROR_POLICY ERRORS_FULL
+#endif
+
+/**
+ * @brief Retry policy.
+ * @details Used in function setRetryPolicy.
+ * - RETRY_BUS_RECOVERY: clock out stuck bus (9 SCL pulses and STOP) and
+ *   restart TwoWire after first failed attempt. Needs SDA/SCL pins.
+ * - RETRY_SOFT_RESET: soft reset sensor after second failed command write.
+ *   Not used in periodic mode, soft reset stops periodic measurement.
+*/
+#define RETRY_NONE          0x00
+#define RETRY_BUS_RECOVERY  0x01
+#define RETRY_SOFT_RESET    0x02
+
+#define NO_PIN              0xFF
+
+/**
+ * @brief Non-blocking measurement states.
+ * @details Returned by function pollSingleShot.
+*/
+#define MEAS_PENDING                0
+#define MEAS_READY                  1
+#define MEAS_FAILED                 2
+
+/**
+ * @brief Measurement result.
+ * @details Returned by value from functions measure and fetch.
+*/
+struct TD_SHT31Measurement
+{
+    uint16_t rawTemperature;    /* Raw ticks */
+    uint16_t rawHumidity;       /* Raw ticks */
+    int16_t temperature;        /* 0.01 degrees */
+    int16_t humidity;           /* 0.01 %RH */
+    uint16_t status;            /* Errors of this call, NO_ERROR if ok */
+    uint8_t retries;            /* NACKed reads (adaptive timing), 0 on failure */
+    uint32_t timestamp;         /* millis() when data was read */
+
+    bool ok() const { return (status == NO_ERROR); }
+};
+
+/**
+ * @brief Calibration.
+ * @details Applied to integer values: value * gain / CAL_GAIN_ONE + offset.
+ * Temperature values are in selected temperature unit.
+*/
+#define CAL_GAIN_ONE        16384
+
+struct TD_SHT31Calibration
+{
+    int16_t tOffset;            /* 0.01 degrees */
+    uint16_t tGain;             /* CAL_GAIN_ONE = 1.0 */
+    int16_t hOffset;            /* 0.01 %RH */
+    uint16_t hGain;             /* CAL_GAIN_ONE = 1.0 */
+};
+
+/**
+ * @brief Calibration persistence hook (e.g. EEPROM or NVS).
+ * @details Same signature is used for load and save.
+*/
+typedef bool (*TD_SHT31CalibrationStore)(TD_SHT31Calibration *cal);
+
+/**
+ * @brief I2C transaction queue, see TD_SHT31Transport.h.
+*/
+class TD_SHT31Transport;
+
+/**
+ * @brief Bus lock, see TD_SHT31Lock.h.
+*/
+class TD_SHT31Lock;
+
+/**
+ * @class TD_SHT31.
+ * @brief TD_SHT31 Class definition.
+*/
+class TD_SHT31
+{
+    public:
+    /**
+     * @brief TD_SHT31 Class forward declaration.
+     * @param[in] I2C address of the SHT31 device
+    */
+    TD_SHT31(uint8_t i2c_device_address);
+
+    /**
+     * @brief Function begin.
+     * @return boolean result
+    */
+    bool begin();
+
+    /**
+     * @brief Function begin.
+     * @param *wire
+     * @return boolean result
+    */    
+    bool begin(TwoWire *wire);
+
+    /**
+     * @brief Function begin.
+     * @param *wire
+     * @param u32Clock I2C clock in Hz (e.g. I2C_CLOCK_400K)
+     * @return boolean result
+    */    
+    bool begin(TwoWire *wire, uint32_t u32Clock);
+
+    /**
+     * @brief Set I2C clock.
+     * @param u32Clock I2C clock in Hz (e.g. I2C_CLOCK_400K)
+     * @return void
+     * @note Applied at once if begin has been called, otherwise in begin.
+    */
+    void setClock(uint32_t u32Clock);
+
+    /**
+     * @brief Route sensor transfers through transaction queue.
+     * @param *transport backend or NULL for direct TwoWire access (default)
+     * @return void
+     * @details Transfers are queued in order with transfers of other users
+     * of the same transport, including reset in begin. Instance has one
+     * transfer descriptor. startSingleShot, pollSingleShot,
+     * startMeasurement, pollMeasurement and pollFetch submit it and return
+     * MEAS_PENDING (or true) until backend has completed it. Other calls
+     * wait for completion and call yield() meanwhile. Bus recovery waits
+     * until transport is idle and then uses pins and TwoWire directly.
+     * @note Instance must not be destroyed while its transfer is queued.
+    */
+    void setTransport(TD_SHT31Transport *transport);
+
+    /**
+     * @brief Set bus lock shared by all sensors on the same bus.
+     * @param *lock lock or NULL (default, no locking)
+     * @return void
+     * @details Lock is held during each I2C transfer, bus recovery and
+     * TwoWire setup in begin and setClock, not during conversion wait or
+     * retry backoff. Set lock before begin.
+     * @note Instance itself is not thread safe, use one instance per task.
+    */
+    void setBusLock(TD_SHT31Lock *lock);
+
+    /**
+     * @brief Check if sensor is connected.
+     * @return boolean result
+    */
+    bool isSensorConnected();   
+
+    /**
+     * @brief Set enable/disable crc and temperature unit. 
+     * @param useCRC (ENABLE_CRC or DISABLE_CRC)
+     * @param tUnit temperature unit (CELSIUS or FARENHEITH)
+     * @return void
+    */
+    void set_defaults(bool useCRC, bool tUnit); 
+
+     /**
+     * @brief Set enable/disable crc, temperature unit, SDA-pin and SLC-pin. 
+     * @param useCRC (ENABLE_CRC or DISABLE_CRC)
+     * @param tUnit temperature unit (CELSIUS or FARENHEITH)
+     * @param dataPIN I2C SDA-pin (only ESP8266 or ESP32)
+     * @param clockPIN I2C SCL-pin (only ESP8266 or ESP32)
+     * @return void
+     * @note Pins are also used in bus recovery (RETRY_BUS_RECOVERY).
+    */   
+    void set_defaults(bool useCRC, bool tUnit, uint8_t dataPIN, uint8_t clockPIN);     
+
+    /**
+     * @brief Enable/disable adaptive conversion timing.
+     * @param enable
+     * @return void
+     * @details Single shot data is read at learned conversion time plus
+     * ADAPTIVE_MARGIN_US instead of datasheet maximum. While sensor is
+     * busy it NACKs the read and read is retried every ADAPTIVE_RETRY_US
+     * until datasheet maximum. Not used with clock stretching commands.
+    */
+    void setAdaptiveTiming(bool enable);
+
+    /**
+     * @brief Return learned conversion time.
+     * @param repeatability (REPEAT_HIGH, REPEAT_MEDIUM or REPEAT_LOW)
+     * @return conversion time in microseconds
+    */
+    uint16_t getConversionTime(uint8_t repeatability);
+
+    /**
+     * @brief Set retry policy for I2C transactions.
+     * @param maxAttempts attempts per transaction, 1 = no retry (default)
+     * @param backoff delay before retry in milliseconds, multiplied by
+     * attempt number
+     * @param flags RETRY_NONE or RETRY_BUS_RECOVERY | RETRY_SOFT_RESET
+     * @return void
+    */
+    void setRetryPolicy(uint8_t maxAttempts, uint8_t backoff, uint8_t flags);
+
+    /**
+     * @brief Return number of retried transactions.
+     * @param void
+     * @return retry count
+    */
+    uint16_t getRetryCount();
+
+    /**
+     * @brief Return number of bus recoveries and soft resets.
+     * @param void
+     * @return recovery count
+    */
+    uint16_t getRecoveryCount();
+
+    /**
+     * @brief Return bus bytes transferred since last call.
+     * @param void
+     * @return bus bytes, address byte of each start included
+     * @details Counted from actual transfers. NACKed transfer counts its
+     * address byte only.
+     * @note When reading counter is cleared.
+    */
+    uint32_t getBusBytes();
+
+    /**
+     * @brief Set I2C bus timeout for clock stretching.
+     * @param u32Timeout timeout in microseconds, 0 = TwoWire default
+     * @return void
+     * @note Supported on AVR (Wire with setWireTimeout), ESP8266 and ESP32.
+    */
+    void setBusTimeout(uint32_t u32Timeout);
+
+    /**
+     * @brief Set calibration.
+     * @param *cal [in] calibration
+     * @return void
+    */
+    void setCalibration(const TD_SHT31Calibration *cal);
+
+    /**
+     * @brief Get calibration.
+     * @param *cal [out] calibration
+     * @return void
+    */
+    void getCalibration(TD_SHT31Calibration *cal);
+
+    /**
+     * @brief Set two-point calibration of temperature or humidity.
+     * @param humidity false = temperature, true = humidity
+     * @param measured1 measured value at point 1 (0.01 units, uncalibrated)
+     * @param reference1 reference value at point 1 (0.01 units)
+     * @param measured2 measured value at point 2
+     * @param reference2 reference value at point 2
+     * @return boolean result, false if measured points are equal or gain
+     * is out of range (0...4), negative slope included
+    */
+    bool setTwoPointCalibration(bool humidity, int16_t measured1,
+        int16_t reference1, int16_t measured2, int16_t reference2);
+
+    /**
+     * @brief Load calibration with persistence hook.
+     * @param load hook
+     * @return boolean result of hook
+    */
+    bool loadCalibration(TD_SHT31CalibrationStore load);
+
+    /**
+     * @brief Save calibration with persistence hook.
+     * @param save hook
+     * @return boolean result of hook
+    */
+    bool saveCalibration(TD_SHT31CalibrationStore save);
+
+    /**
+     * @brief Attach statistics accumulator.
+     * @param *stats accumulator or NULL to detach
+     * @return void
+     * @details Every decoded measurement (single shot, periodic, raw or
+     * converted) is added in 0.01 units with calibration applied.
+    */
+    void setStatistics(TD_SHT31Statistics *stats);
+
+    /**
+     * @brief Reset sensor
+     * @param command
+     * @return boolean result
+     * @note Only commands CMD_SOFT_RESET or CMD_GCALL_RESET are allowed.
+    */
+    bool resetSensor(uint16_t command);
+
+    /**
+     * @brief Execute single shot measurement.
+     * @param u16Command
+     * @param *fT [out] float *temperature
+     * @param *fH [out] float *humidity
+     * @return boolean result
+    */    
+    bool runSingleShot(uint16_t u16Command, float *fT, float *fH);
+
+    /**
+     * @brief Execute single shot measurement, integer result.
+     * @param u16Command
+     * @param *iT [out] temperature in 0.01 degrees
+     * @param *iH [out] humidity in 0.01 %RH
+     * @return boolean result
+    */    
+    bool runSingleShot(uint16_t u16Command, int16_t *iT, int16_t *iH);
+
+    /**
+     * @brief Execute single shot measurement, raw result without conversion.
+     * @param u16Command
+     * @param *u16T [out] raw temperature ticks
+     * @param *u16H [out] raw humidity ticks
+     * @return boolean result
+    */    
+    bool runSingleShotRaw(uint16_t u16Command, uint16_t *u16T, uint16_t *u16H);
+
+    /**
+     * @brief Execute single shot measurement, structured result.
+     * @param u16Command
+     * @return TD_SHT31Measurement
+     * @note With ERRORS_NONE policy status is NO_ERROR or ERROR_UNKNOWN.
+    */
+    TD_SHT31Measurement measure(uint16_t u16Command);
+
+    /**
+     * @brief Start single shot measurement without waiting.
+     * @param u16Command
+     * @return boolean result
+     * @note Use pollSingleShot to collect the result. With CMD_SS_CSE_*
+     * commands pollSingleShot reads at once and the sensor stretches the
+     * clock until conversion is done.
+    */
+    bool startSingleShot(uint16_t u16Command);
+
+    /**
+     * @brief Poll single shot measurement started by startSingleShot.
+     * @param *fT [out] float *temperature
+     * @param *fH [out] float *humidity
+     * @return MEAS_PENDING, MEAS_READY or MEAS_FAILED
+     * @note Returns MEAS_PENDING until conversion time has elapsed.
+    */
+    uint8_t pollSingleShot(float *fT, float *fH);
+
+    /**
+     * @brief Poll single shot measurement, integer result.
+     * @param *iT [out] temperature in 0.01 degrees
+     * @param *iH [out] humidity in 0.01 %RH
+     * @return MEAS_PENDING, MEAS_READY or MEAS_FAILED
+    */
+    uint8_t pollSingleShot(int16_t *iT, int16_t *iH);
+
+    /**
+     * @brief Poll single shot measurement, raw result without conversion.
+     * @param *u16T [out] raw temperature ticks
+     * @param *u16H [out] raw humidity ticks
+     * @return MEAS_PENDING, MEAS_READY or MEAS_FAILED
+    */
+    uint8_t pollSingleShotRaw(uint16_t *u16T, uint16_t *u16H);
+
+    /**
+     * @brief Start single shot measurement, structured result.
+     * @param u16Command
+     * @param *result [out] valid when MEAS_FAILED is returned
+     * @return MEAS_PENDING or MEAS_FAILED
+     * @note Use pollMeasurement to collect the result.
+    */
+    uint8_t startMeasurement(uint16_t u16Command, TD_SHT31Measurement *result);
+
+    /**
+     * @brief Poll single shot measurement, structured result.
+     * @param *result [out] valid when MEAS_READY or MEAS_FAILED is returned
+     * @return MEAS_PENDING, MEAS_READY or MEAS_FAILED
+    */
+    uint8_t pollMeasurement(TD_SHT31Measurement *result);
+
+    /**
+     * @brief Start periodic measurement.
+     * @param rate (PER_RATE_05, PER_RATE_1, PER_RATE_2, PER_RATE_4 or PER_RATE_10)
+     * @param repeatability (REPEAT_HIGH, REPEAT_MEDIUM or REPEAT_LOW)
+     * @return boolean result
+     * @note Running periodic mode is stopped first.
+    */
+    bool startPeriodic(uint8_t rate, uint8_t repeatability);
+
+    /**
+     * @brief Fetch latest periodic measurement.
+     * @param *fT [out] float *temperature
+     * @param *fH [out] float *humidity
+     * @return boolean result
+     * @note Fails with ERROR_REQUEST_LEN if no new data is available.
+    */
+    bool fetchPeriodic(float *fT, float *fH);
+
+    /**
+     * @brief Fetch latest periodic measurement, integer result.
+     * @param *iT [out] temperature in 0.01 degrees
+     * @param *iH [out] humidity in 0.01 %RH
+     * @return boolean result
+    */
+    bool fetchPeriodic(int16_t *iT, int16_t *iH);
+
+    /**
+     * @brief Fetch latest periodic measurement, raw result without conversion.
+     * @param *u16T [out] raw temperature ticks
+     * @param *u16H [out] raw humidity ticks
+     * @return boolean result
+    */
+    bool fetchPeriodicRaw(uint16_t *u16T, uint16_t *u16H);
+
+    /**
+     * @brief Fetch latest periodic measurement, structured result.
+     * @param void
+     * @return TD_SHT31Measurement
+     * @note With ERRORS_NONE policy status is NO_ERROR or ERROR_UNKNOWN.
+    */
+    TD_SHT31Measurement fetch();
+
+    /**
+     * @brief Fetch latest periodic measurement without waiting for transport.
+     * @param *result [out] valid when MEAS_READY or MEAS_FAILED is returned
+     * @return MEAS_PENDING, MEAS_READY or MEAS_FAILED
+     * @note Without transport fetch is done at once and MEAS_PENDING is
+     * never returned.
+    */
+    uint8_t pollFetch(TD_SHT31Measurement *result);
+
+    /**
+     * @brief Fetch latest periodic measurement into ring buffer.
+     * @param *buffer [out] ring buffer, raw sample with millis() timestamp
+     * @return boolean result
+     * @note Sample is dropped and ERROR_BUFFER_FULL set if buffer is full.
+    */
+    template <uint8_t N>
+    bool fetchPeriodic(TD_SHT31RingBuffer<N> *buffer)
+    {
+        TD_SHT31Sample sample;
+        if (fetchPeriodicRaw(&sample.temperature, &sample.humidity) == false)
+        {
+            return false;
+        }
+        sample.timestamp = millis();
+        if (buffer->push(sample) == false)
+        {
+            setError(ERROR_BUFFER_FULL);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Raw tick converters - refer datasheet page 14.
+     * @details Integer converters return 0.01 units and use multiply-shift,
+     * error is below 0.01 units. Float converters use datasheet formulas.
+    */
+    static inline int16_t ticksToCentiCelsius(uint16_t u16T)
+    {
+        return (int16_t) (((uint32_t) u16T * 4375 + 8192) >> 14) - 4500;
+    }
+
+    static inline int16_t ticksToCentiFarenheit(uint16_t u16T)
+    {
+        return (int16_t) (((uint32_t) u16T * 7875 + 8192) >> 14) - 4900;
+    }
+
+    static inline int16_t ticksToCentiHumidity(uint16_t u16H)
+    {
+        return (int16_t) (((uint32_t) u16H * 625 + 2048) >> 12);
+    }
+
+    static inline float ticksToCelsius(uint16_t u16T)
+    {
+        return u16T * (175.0f / 65535) - 45;
+    }
+
+    static inline float ticksToFarenheit(uint16_t u16T)
+    {
+        return u16T * (315.0f / 65535) - 49;
+    }
+
+    static inline float ticksToHumidity(uint16_t u16H)
+    {
+        return u16H * (100.0f / 65535);
+    }
+
+    /**
+     * @brief Calculate checksum - refer datasheet page 14.
+     * @param *data [in] data buffer
+     * @param len data length (len)
+     * @return CRC (uint8_t)
+     * @note Method is selected with TD_SHT31_CRC_METHOD.
+    */
+    static uint8_t crc8(const uint8_t *data, uint8_t len);
+
+    /**
+     * @brief Start ART (accelerated response time) periodic measurement.
+     * @param void
+     * @return boolean result
+     * @details Sensor measures at 4 Hz. Use fetchPeriodic to read data and
+     * stopPeriodic to exit. Running periodic mode is stopped first.
+    */
+    bool enableART();
+
+    /**
+     * @brief Return measurement mode.
+     * @param void
+     * @return MODE_IDLE, MODE_PERIODIC or MODE_ART
+    */
+    uint8_t getMode();
+
+    /**
+     * @brief Stop periodic or ART measurement (break command).
+     * @param void
+     * @return boolean result
+    */
+    bool stopPeriodic();
+
+    /**
+     * @brief Clear sensor status.
+     * @param void
+     * @return boolean result
+    */
+    bool clearSensorStatus();
+
+    /**
+     * @brief Read sensor status.
+     * @param void
+     * @return Sensor status
+     * @note If function fails to read status, value 0xFFFF is returned.
+    */
+    uint16_t readSensorStatus();    
+    
+    /**
+     * @brief Return last error.
+     * @param void
+     * @return error code (_error_code)
+     * @note When reading _error_code is cleared. Depends on
+     * TD_SHT31_ERROR_POLICY.
+    */
+    int getLastError();
+
+    /**
+     * @brief TD_SHT31 Class private declarations.
+    */
+    private:  
+    TwoWire* _i2c;
+    TD_SHT31Transport *_transport;
+    TD_SHT31Lock *_busLock;
+    TD_SHT31Statistics *_stats;
+    uint32_t _busTimeout;
+    uint32_t _clock;
+    uint8_t _retryAttempts;
+    uint8_t _retryBackoff;
+    uint8_t _retryFlags;
+    uint16_t _retryCount;
+    uint16_t _recoveryCount;
+    uint32_t _busBytes;
+    uint8_t _sdaPIN;
+    uint8_t _slcPIN;
+    uint8_t _i2c_device_address;
+    #if TD_SHT31_ERROR_POLICY == ERRORS_FULL
+    int _error_code;            /* Error bits since getLastError */
+    #elif TD_SHT31_ERROR_POLICY == ERRORS_LEAN
+    uint16_t _error_code;       /* Error of latest call */
+    #endif
+    bool _useCRC = ENABLE_CRC;
+    bool _tUnit = CELSIUS;   
+    bool _calibrated = false;
+    TD_SHT31Calibration _cal;
+    bool _ssActive = false;
+    uint8_t _mode = MODE_IDLE;
+    bool _adaptive = false;
+    uint8_t _ssRepeat;          /* Repeatability of active single shot */
+    uint8_t _ssRetries;         /* NACKed reads of active single shot */
+    uint16_t _ssWait;           /* Microseconds from _ssStart to next read */
+    uint16_t _ssMax;            /* Datasheet maximum in microseconds */
+    uint32_t _ssStart;
+    uint32_t _ssRead;           /* Microseconds from _ssStart to queued read */
+    uint16_t _learned[3];       /* Learned conversion times, microseconds */
+    TD_SHT31Transfer _xfer;     /* Transfer of this instance on transport */
+    uint8_t _xferStage;         /* Operation waiting for _xfer */
+    uint8_t _xferAttempt;
+    uint8_t _xferData[6];       /* Read data of queued operation */
+
+    /**
+     * @brief Record error according to TD_SHT31_ERROR_POLICY.
+     * @param code error code
+     * @return void
+    */
+    inline void setError(int code)
+    {
+        #if TD_SHT31_ERROR_POLICY == ERRORS_FULL
+        _error_code |= code;
+        #elif TD_SHT31_ERROR_POLICY == ERRORS_LEAN
+        _error_code = (uint16_t) code;
+        #else
+        (void) code;
+        #endif
+    }
+
+    /**
+     * @brief Start status of public call, ERRORS_LEAN keeps only latest.
+     * @param void
+     * @return void
+    */
+    inline void beginCall()
+    {
+        #if TD_SHT31_ERROR_POLICY == ERRORS_LEAN
+        _error_code = NO_ERROR;
+        #endif
+    }
+
+    /**
+     * @brief Apply gain and offset.
+     * @param value 0.01 units
+     * @param gain CAL_GAIN_ONE = 1.0
+     * @param offset 0.01 units
+     * @return calibrated value, limited to int16_t range
+    */
+    static int16_t calibrate(int16_t value, uint16_t gain, int16_t offset);
+
+    /**
+     * @brief Complete structured result.
+     * @param *result [in,out] result with raw ticks
+     * @param success result of measurement call
+     * @param savedError _error_code before measurement call
+     * @return void
+    */
+    void completeMeasurement(TD_SHT31Measurement *result, bool success,
+                             int savedError);
+
+    /**
+     * @brief Apply _busTimeout to TwoWire.
+     * @param void
+     * @return void
+    */
+    void applyBusTimeout();
+
+    /**
+     * @brief Update learned conversion time of active single shot.
+     * @param u32Elapsed microseconds from start to successful read
+     * @return void
+    */
+    void learnConversionTime(uint32_t u32Elapsed);
+
+    /**
+     * @brief Read bytes to buffer, retry according to retry policy.
+     * @param *buffer [out] data buffer
+     * @param data length (len)
+     * @return boolean result
+    */
+    bool readBytes(uint8_t *buffer, uint8_t len);
+
+    /**
+     * @brief Acquire and release bus lock if set.
+     * @param void
+     * @return void
+    */
+    void lockBus();
+    void unlockBus();
+
+    /**
+     * @brief Execute transfer with transport and wait for completion.
+     * @details Used by blocking calls. Waits with yield() for queued
+     * single shot or fetch transfer first and restores its result, so it
+     * is still collected by the next poll.
+     * @param *wdata [in] write data or NULL
+     * @param wlen write length (0...2)
+     * @param *rdata [out] read data or NULL
+     * @param rlen read length
+     * @return NO_ERROR or error code
+    */
+    int queueTransfer(const uint8_t *wdata, uint8_t wlen, uint8_t *rdata, uint8_t rlen);
+
+    /**
+     * @brief Submit _xfer to transport.
+     * @param stage operation waiting for transfer
+     * @param *wdata [in] write data or NULL
+     * @param wlen write length (0...2)
+     * @param *rdata [out] read data or NULL
+     * @param rlen read length
+     * @return void
+    */
+    void submitTransfer(uint8_t stage, const uint8_t *wdata, uint8_t wlen,
+                        uint8_t *rdata, uint8_t rlen);
+
+    /**
+     * @brief Collect _xfer of queued operation.
+     * @param *error [out] transfer result when true is returned
+     * @param retry resubmit failed transfer according to retry policy
+     * @return false while transfer is queued or resubmitted
+     * @note Resubmit has no backoff, bus recovery or soft reset.
+    */
+    bool transferDone(int *error, bool retry);
+
+    /**
+     * @brief Check if _xfer is still queued.
+     * @param void
+     * @return boolean result
+     * @note Completed transfer of abandoned operation is released.
+    */
+    bool transferBusy();
+
+    /**
+     * @brief Poll single shot measurement on transport.
+     * @param *u16T [out] raw temperature ticks
+     * @param *u16H [out] raw humidity ticks
+     * @return MEAS_PENDING, MEAS_READY or MEAS_FAILED
+    */
+    uint8_t pollSingleShotQueued(uint16_t *u16T, uint16_t *u16H);
+
+    /**
+     * @brief Learn conversion time and decode data of single shot.
+     * @param *buffer [in] 6 data bytes
+     * @param u32Elapsed microseconds from start to successful read
+     * @param *u16T [out] raw temperature ticks
+     * @param *u16H [out] raw humidity ticks
+     * @return MEAS_READY or MEAS_FAILED
+    */
+    uint8_t finishSingleShot(const uint8_t *buffer, uint32_t u32Elapsed,
+                             uint16_t *u16T, uint16_t *u16H);
+
+    /**
+     * @brief Read bytes to buffer, no error code on NACK.
+     * @param *buffer [out] data buffer
+     * @param data length (len)
+     * @return boolean result
+    */
+    bool tryReadBytes(uint8_t *buffer, uint8_t len);
+
+    /**
+     * @brief CRC-check and decode raw sensor data.
+     * @param *buffer [in] 6 data bytes
+     * @param *u16T [out] raw temperature ticks
+     * @param *u16H [out] raw humidity ticks
+     * @return boolean result
+    */    
+    bool decodeSensorData(const uint8_t *buffer, uint16_t *u16T, uint16_t *u16H);
+
+    /**
+     * @brief Convert raw ticks into 0.01 units and apply calibration.
+     * @param u16T raw temperature ticks
+     * @param u16H raw humidity ticks
+     * @param *iT [out] temperature in 0.01 degrees
+     * @param *iH [out] humidity in 0.01 %RH
+     * @return void
+    */
+    void convertData(uint16_t u16T, uint16_t u16H, int16_t *iT, int16_t *iH);
+
+    /**
+     * @brief Return conversion time of single shot command.
+     * @param u16Command
+     * @return conversion time in milliseconds, 0 with clock stretching
+    */
+    uint8_t conversionTime(uint16_t u16Command);
+
+    /**
+     * @brief Return repeatability of single shot command.
+     * @param u16Command
+     * @return REPEAT_HIGH, REPEAT_MEDIUM or REPEAT_LOW
+    */
+    uint8_t repeatability(uint16_t u16Command);
+
+    /**
+     * @brief Write command to sensor, retry according to retry policy.
+     * @param command
+     * @return boolean result
+    */
+    bool writeCommand(uint16_t command);
+
+    /**
+     * @brief Write command to sensor once.
+     * @param command
+     * @return NO_ERROR, ERROR_WRITE_LEN or ERROR_END_TRANSMISSION
+    */
+    int writeCommandOnce(uint16_t command);
+
+    /**
+     * @brief Write command and read response with repeated start, retry
+     * according to retry policy.
+     * @param command
+     * @param *buffer [out] data buffer
+     * @param len data length
+     * @return boolean result
+    */
+    bool readCommand(uint16_t command, uint8_t *buffer, uint8_t len);
+
+    /**
+     * @brief Write command and read response once.
+     * @param command
+     * @param *buffer [out] data buffer
+     * @param len data length
+     * @return NO_ERROR, ERROR_WRITE_LEN, ERROR_END_TRANSMISSION or
+     * ERROR_REQUEST_LEN
+    */
+    int readCommandOnce(uint16_t command, uint8_t *buffer, uint8_t len);
+
+    /**
+     * @brief Add bytes of one transaction to bus byte counter.
+     * @param wlen write length, write is sent if wlen != 0 or rlen == 0
+     * @param rlen read length
+     * @param error result of transaction
+     * @return void
+    */
+    void countTransfer(uint8_t wlen, uint8_t rlen, int error);
+
+    /**
+     * @brief Prepare retry after failed attempt.
+     * @param attempt failed attempt number (1...)
+     * @param allowReset soft reset allowed
+     * @return void
+    */
+    void prepareRetry(uint8_t attempt, bool allowReset);
+
+    /**
+     * @brief Clock out stuck bus and restart TwoWire.
+     * @param void
+     * @return boolean result, false if pins are unknown
+    */
+    bool recoverBus();
+};
+
+#endif  //TD_SHT31_H
@@ -0,0 +1,214 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Bus.cpp
+ * @brief Multi-sensor manager for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations. 
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+
+#include "TD_SHT31Bus.h"
+
+/**
+ * @brief Multiplexer state not known, e.g. changed by others.
+*/
+#define MUX_UNKNOWN             0xFE
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Initialize TD_SHT31Bus Class.
+ * ----------------------------------------------------------------------------
+*/
+TD_SHT31Bus::TD_SHT31Bus()
+{
+    _count     = 0;
+    _channel   = MUX_UNKNOWN;
+    _busBytes  = 0;
+    _muxSelect = NULL;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void setMuxSelect(TD_SHT31MuxSelect muxSelect).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Bus::setMuxSelect(TD_SHT31MuxSelect muxSelect)
+{
+    _muxSelect = muxSelect;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool addSensor(TD_SHT31 *sensor, uint8_t channel).
+ * @details Insert sensor into _order after sensors with same or lower
+ * channel.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31Bus::addSensor(TD_SHT31 *sensor, uint8_t channel)
+{
+    if ((sensor == NULL) || (_count >= SHT31_BUS_MAX_SENSORS))
+    {
+        return false;
+    }
+    _sensors[_count].sensor  = sensor;
+    _sensors[_count].channel = channel;
+    _sensors[_count].state   = MEAS_FAILED;
+
+    uint8_t i = _count;
+    while ((i > 0) && (_sensors[_order[i - 1]].channel > channel))
+    {
+        _order[i] = _order[i - 1];
+        i--;
+    }
+    _order[i] = _count;
+    _count++;
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t getSensorCount().
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TD_SHT31Bus::getSensorCount()
+{
+    return _count;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool startAll(uint16_t u16Command).
+ * @details Write command to all sensors back-to-back, no wait.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31Bus::startAll(uint16_t u16Command)
+{
+    bool result = true;
+    _channel = MUX_UNKNOWN;     /* Mux may have been changed by others */
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        Entry *entry = &_sensors[_order[i]];
+        entry->state = MEAS_FAILED;
+        if (selectChannel(entry->channel) && \
+            entry->sensor->startSingleShot(u16Command))
+        {
+            entry->state = MEAS_PENDING;
+        } else
+        {
+            result = false;
+        }
+    }
+    return result;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t pollAll().
+ * @details
+ * - Collect results of sensors whose conversion time has elapsed.
+ * - Return MEAS_PENDING until all sensors are done.
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TD_SHT31Bus::pollAll()
+{
+    uint8_t result = MEAS_READY;
+    _channel = MUX_UNKNOWN;     /* Mux may have been changed by others */
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        Entry *entry = &_sensors[_order[i]];
+        if (entry->state == MEAS_PENDING)
+        {
+            if (selectChannel(entry->channel) == false)
+            {
+                entry->state = MEAS_FAILED;
+            } else
+            {
+                entry->state = entry->sensor->pollSingleShot(
+                    &entry->temperature, &entry->humidity);
+            }
+        }
+        if (entry->state == MEAS_PENDING)
+        {
+            result = MEAS_PENDING;
+        } else if ((entry->state == MEAS_FAILED) && (result != MEAS_PENDING))
+        {
+            result = MEAS_FAILED;
+        }
+    }
+    return result;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool runAll(uint16_t u16Command).
+ * @details Blocking wrapper for startAll and pollAll.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31Bus::runAll(uint16_t u16Command)
+{
+    bool result = startAll(u16Command);
+
+    uint8_t state;
+    while ((state = pollAll()) == MEAS_PENDING)
+    {
+        delay(1);
+    }
+    return result && (state == MEAS_READY);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool getResult(uint8_t index, int16_t *iT, int16_t *iH).
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31Bus::getResult(uint8_t index, int16_t *iT, int16_t *iH)
+{
+    if ((index >= _count) || (_sensors[index].state != MEAS_READY))
+    {
+        return false;
+    }
+    *iT = _sensors[index].temperature;
+    *iH = _sensors[index].humidity;
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint32_t getBusBytes().
+ * ----------------------------------------------------------------------------
+*/
+uint32_t TD_SHT31Bus::getBusBytes()
+{
+    uint32_t retval = _busBytes;
+    _busBytes = 0;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        retval += _sensors[i].sensor->getBusBytes();
+    }
+    return retval;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool selectChannel(uint8_t channel).
+ * @details Sensors on NO_MUX_CHANNEL are last in _order, so channels are
+ * deselected once per sweep.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31Bus::selectChannel(uint8_t channel)
+{
+    if ((_muxSelect == NULL) || (channel == _channel))
+    {
+        return true;
+    }
+    if (_muxSelect(channel) == false)
+    {
+        _channel = MUX_UNKNOWN;
+        _busBytes += 1;
+        return false;
+    }
+    _channel = channel;
+    _busBytes += BUS_BYTES_MUX_SELECT;
+    return true;
+}
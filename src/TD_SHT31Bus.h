@@ -0,0 +1,165 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Bus.h
+ * @brief Multi-sensor manager for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations. 
+ * Measurement command is written to all sensors back-to-back and results
+ * are collected after one conversion time, so N sensors cost roughly one
+ * conversion time instead of N.
+ * Sensors behind I2C multiplexer (e.g. TCA9548A) are supported with
+ * channel select hook. Sensors are accessed in channel order so that each
+ * channel is selected only once per sweep.
+ * @note SHT31 general call supports only reset, so measurement commands
+ * can not be broadcast.
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef TD_SHT31_BUS_H
+#define TD_SHT31_BUS_H
+
+#include "TD_SHT31.h"
+
+/**
+ * @brief Maximum number of sensors.
+ * @details Change with build flag, e.g. -DSHT31_BUS_MAX_SENSORS=32, so
+ * that library source and sketch see the same class layout. Define in
+ * sketch does not reach library source.
+*/
+#ifndef SHT31_BUS_MAX_SENSORS
+#define SHT31_BUS_MAX_SENSORS   16
+#endif
+
+/**
+ * @brief Channel of sensor connected directly to bus (no multiplexer).
+ * @details Select hook is called with NO_MUX_CHANNEL to deselect all
+ * channels before direct sensors are accessed, so devices behind
+ * multiplexer with same address do not answer. Sensor behind multiplexer
+ * can not share address with direct sensor, they collide while its
+ * channel is selected.
+*/
+#define NO_MUX_CHANNEL          0xFF
+
+/**
+ * @brief Bus bytes of multiplexer channel select, address byte included.
+ * @details Hook does the transfer, so failed select counts address byte.
+*/
+#define BUS_BYTES_MUX_SELECT    2
+
+/**
+ * @brief Multiplexer channel select hook.
+ * @details Channel is 0...7 or NO_MUX_CHANNEL (deselect all channels).
+ * Example for TCA9548A at address 0x70:
+ * bool selectChannel(uint8_t channel)
+ * {
+ *     Wire.beginTransmission(0x70);
+ *     Wire.write((channel == NO_MUX_CHANNEL) ? 0 : (1 << channel));
+ *     return (Wire.endTransmission() == 0);
+ * }
+*/
+typedef bool (*TD_SHT31MuxSelect)(uint8_t channel);
+
+/**
+ * @class TD_SHT31Bus.
+ * @brief TD_SHT31Bus Class definition.
+*/
+class TD_SHT31Bus
+{
+    public:
+    /**
+     * @brief TD_SHT31Bus Class forward declaration.
+    */
+    TD_SHT31Bus();
+
+    /**
+     * @brief Set multiplexer channel select hook.
+     * @param muxSelect hook or NULL
+     * @return void
+    */
+    void setMuxSelect(TD_SHT31MuxSelect muxSelect);
+
+    /**
+     * @brief Add sensor.
+     * @param *sensor initialized TD_SHT31 instance
+     * @param channel multiplexer channel or NO_MUX_CHANNEL
+     * @return boolean result
+    */
+    bool addSensor(TD_SHT31 *sensor, uint8_t channel = NO_MUX_CHANNEL);
+
+    /**
+     * @brief Return number of sensors.
+     * @param void
+     * @return sensor count
+    */
+    uint8_t getSensorCount();
+
+    /**
+     * @brief Start single shot measurement on all sensors.
+     * @param u16Command
+     * @return boolean result, false if any sensor failed to start
+    */
+    bool startAll(uint16_t u16Command);
+
+    /**
+     * @brief Poll all sensors started by startAll.
+     * @param void
+     * @return MEAS_PENDING, MEAS_READY or MEAS_FAILED (any sensor failed)
+    */
+    uint8_t pollAll();
+
+    /**
+     * @brief Execute single shot measurement on all sensors.
+     * @param u16Command
+     * @return boolean result, false if any sensor failed
+    */
+    bool runAll(uint16_t u16Command);
+
+    /**
+     * @brief Return result of one sensor.
+     * @param index sensor index (order of addSensor calls)
+     * @param *iT [out] temperature in 0.01 degrees
+     * @param *iH [out] humidity in 0.01 %RH
+     * @return boolean result, false if sensor has no valid result
+    */
+    bool getResult(uint8_t index, int16_t *iT, int16_t *iH);
+
+    /**
+     * @brief Return bus bytes transferred since last call.
+     * @param void
+     * @return bus bytes (address bytes included)
+     * @details Sum of sensor counters (TD_SHT31::getBusBytes), which count
+     * actual transfers including NACKs and retries, and channel selects.
+     * @note When reading counters of bus and sensors are cleared.
+    */
+    uint32_t getBusBytes();
+
+    /**
+     * @brief TD_SHT31Bus Class private declarations.
+    */
+    private:
+    struct Entry
+    {
+        TD_SHT31 *sensor;
+        uint8_t channel;
+        uint8_t state;
+        int16_t temperature;
+        int16_t humidity;
+    };
+
+    Entry _sensors[SHT31_BUS_MAX_SENSORS];
+    uint8_t _order[SHT31_BUS_MAX_SENSORS];  /* _sensors indexes in channel order */
+    uint8_t _count;
+    uint8_t _channel;                       /* Selected channel or MUX_UNKNOWN */
+    uint32_t _busBytes;
+    TD_SHT31MuxSelect _muxSelect;
+
+    /**
+     * @brief Select multiplexer channel if not already selected.
+     * @details NO_MUX_CHANNEL deselects all channels.
+     * @param channel
+     * @return boolean result
+    */
+    bool selectChannel(uint8_t channel);
+};
+
+#endif  //TD_SHT31_BUS_H
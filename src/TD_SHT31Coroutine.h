@@ -0,0 +1,376 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Coroutine.h
+ * @brief C++20 coroutine front-end for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations.
+ * Measurement suspends the coroutine during conversion instead of
+ * blocking, so many sensors interleave on one thread:
+ *
+ * TD_SHT31Task readSensor(TD_SHT31Executor *ex, TD_SHT31 *sht)
+ * {
+ *     TD_SHT31Measurement m = co_await ex->measure(sht, CMD_SS_CSD_HIGH);
+ *     co_await ex->sleep(1000000);
+ * }
+ * ...
+ * executor.spawn(readSensor(&executor, &sht));
+ * executor.run();
+ *
+ * Available only if compiler supports coroutines (__cpp_impl_coroutine,
+ * e.g. -std=c++20), otherwise this header is empty. Single thread only.
+ * Timers use hashed timer wheel, awaiters are linked into it, no dynamic
+ * allocation besides coroutine frames.
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef TD_SHT31_COROUTINE_H
+#define TD_SHT31_COROUTINE_H
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define TD_SHT31_HAS_COROUTINES 1
+#endif
+#endif
+
+#if defined(TD_SHT31_HAS_COROUTINES)
+
+#include <coroutine>
+#include <exception>
+#include "TD_SHT31.h"
+
+/**
+ * @brief Timer wheel slots and slot length in microseconds.
+ * @details Horizon of one wheel round is SHT31_WHEEL_SLOTS *
+ * SHT31_WHEEL_TICK_US, longer timers wait for more rounds. Measurement
+ * is polled once per tick.
+*/
+#ifndef SHT31_WHEEL_SLOTS
+#define SHT31_WHEEL_SLOTS       64
+#endif
+#ifndef SHT31_WHEEL_TICK_US
+#define SHT31_WHEEL_TICK_US     500
+#endif
+
+class TD_SHT31Executor;
+
+/**
+ * @brief Timer wheel entry.
+ * @details poll is NULL for plain timer. Otherwise it is called at expiry
+ * and entry is re-armed for next tick until poll returns true.
+*/
+struct TD_SHT31TimerNode
+{
+    uint32_t due;                           /* micros() */
+    std::coroutine_handle<> handle;
+    bool (*poll)(TD_SHT31TimerNode *node);
+    void *context;
+    TD_SHT31TimerNode *next;
+};
+
+/**
+ * @class TD_SHT31Task.
+ * @brief Fire-and-forget coroutine started with TD_SHT31Executor::spawn.
+*/
+class TD_SHT31Task
+{
+    public:
+    struct promise_type
+    {
+        TD_SHT31Executor *executor = nullptr;
+
+        TD_SHT31Task get_return_object()
+        {
+            return TD_SHT31Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+        ~promise_type();
+    };
+
+    explicit TD_SHT31Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+    TD_SHT31Task(TD_SHT31Task &&other) noexcept : _handle(other._handle) { other._handle = nullptr; }
+    TD_SHT31Task(const TD_SHT31Task &) = delete;
+    TD_SHT31Task &operator=(const TD_SHT31Task &) = delete;
+
+    /**
+     * @brief Destroy task that was never spawned.
+    */
+    ~TD_SHT31Task()
+    {
+        if (_handle)
+        {
+            _handle.destroy();
+        }
+    }
+
+    private:
+    friend class TD_SHT31Executor;
+    std::coroutine_handle<promise_type> _handle;
+};
+
+/**
+ * @class TD_SHT31Executor.
+ * @brief Single threaded executor with timer wheel.
+*/
+class TD_SHT31Executor
+{
+    public:
+    /**
+     * @brief Awaiter of function sleep.
+    */
+    struct SleepAwaiter
+    {
+        TD_SHT31Executor *executor;
+        uint32_t u32Delay;
+        TD_SHT31TimerNode node;
+
+        bool await_ready() const noexcept { return (u32Delay == 0); }
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            node.handle = handle;
+            node.poll   = nullptr;
+            executor->schedule(&node, micros() + u32Delay);
+        }
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief Awaiter of function measure.
+    */
+    struct MeasureAwaiter
+    {
+        TD_SHT31Executor *executor;
+        TD_SHT31 *sensor;
+        uint16_t u16Command;
+        TD_SHT31TimerNode node;
+        TD_SHT31Measurement result;
+
+        bool await_ready() const noexcept { return false; }
+
+        /* Resume at once if command could not be started */
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            if (sensor->startMeasurement(u16Command, &result) == MEAS_FAILED)
+            {
+                return false;
+            }
+            node.handle  = handle;
+            node.poll    = &MeasureAwaiter::poll;
+            node.context = this;
+            executor->schedule(&node, micros() + SHT31_WHEEL_TICK_US);
+            return true;
+        }
+
+        TD_SHT31Measurement await_resume() const noexcept { return result; }
+
+        static bool poll(TD_SHT31TimerNode *node)
+        {
+            MeasureAwaiter *self = static_cast<MeasureAwaiter *>(node->context);
+            return (self->sensor->pollMeasurement(&self->result) != MEAS_PENDING);
+        }
+    };
+
+    TD_SHT31Executor() : _ready(nullptr), _readyTail(nullptr), _live(0), _pending(0)
+    {
+        for (uint8_t i = 0; i < SHT31_WHEEL_SLOTS; i++)
+        {
+            _slots[i] = nullptr;
+        }
+        _tick = micros() / SHT31_WHEEL_TICK_US;
+    }
+
+    /**
+     * @brief Start task. Executor owns task until it finishes.
+     * @param task
+     * @return void
+    */
+    void spawn(TD_SHT31Task task)
+    {
+        std::coroutine_handle<TD_SHT31Task::promise_type> handle = task._handle;
+        task._handle = nullptr;
+        handle.promise().executor = this;
+        _live++;
+        handle.resume();
+    }
+
+    /**
+     * @brief Suspend for u32Delay microseconds.
+     * @param u32Delay
+     * @return awaiter
+    */
+    SleepAwaiter sleep(uint32_t u32Delay)
+    {
+        return SleepAwaiter{this, u32Delay, {}};
+    }
+
+    /**
+     * @brief Single shot measurement, suspends until result is read.
+     * @param *sensor
+     * @param u16Command single shot command
+     * @return awaiter, co_await returns TD_SHT31Measurement
+    */
+    MeasureAwaiter measure(TD_SHT31 *sensor, uint16_t u16Command)
+    {
+        return MeasureAwaiter{this, sensor, u16Command, {}, {}};
+    }
+
+    /**
+     * @brief Run expired timers and resume their coroutines.
+     * @param void
+     * @return true while tasks are alive
+    */
+    bool runOnce()
+    {
+        uint32_t u32Now = micros();
+        uint32_t u32Tick = u32Now / SHT31_WHEEL_TICK_US;
+        uint32_t u32Steps = u32Tick - _tick + 1;
+        if (u32Steps > SHT31_WHEEL_SLOTS)
+        {
+            u32Steps = SHT31_WHEEL_SLOTS;
+        }
+        for (uint32_t i = 0; (i < u32Steps) && (_pending != 0); i++)
+        {
+            expire((uint8_t) ((u32Tick - i) % SHT31_WHEEL_SLOTS), u32Now);
+        }
+        _tick = u32Tick;
+
+        while (_ready != nullptr)
+        {
+            TD_SHT31TimerNode *node = _ready;
+            _ready = node->next;
+            if (_ready == nullptr)
+            {
+                _readyTail = nullptr;
+            }
+            node->handle.resume();
+        }
+        return (_live != 0);
+    }
+
+    /**
+     * @brief Run until all tasks have finished.
+     * @param void
+     * @return void
+     * @details Sleeps with delay until earliest timer is due, running
+     * measurements are polled once per tick. Call runOnce from loop
+     * instead to share the CPU with other code.
+    */
+    void run()
+    {
+        while (runOnce())
+        {
+            sleepUntilDue();
+        }
+    }
+
+    /**
+     * @brief Return number of alive tasks.
+     * @param void
+     * @return task count
+    */
+    uint16_t tasks() const
+    {
+        return _live;
+    }
+
+    private:
+    friend struct TD_SHT31Task::promise_type;
+
+    TD_SHT31TimerNode *_slots[SHT31_WHEEL_SLOTS];
+    TD_SHT31TimerNode *_ready;
+    TD_SHT31TimerNode *_readyTail;
+    uint32_t _tick;             /* Last processed wheel tick */
+    uint16_t _live;             /* Spawned tasks not finished */
+    uint16_t _pending;          /* Nodes in wheel */
+
+    void schedule(TD_SHT31TimerNode *node, uint32_t u32Due)
+    {
+        uint8_t slot = (uint8_t) ((u32Due / SHT31_WHEEL_TICK_US) % SHT31_WHEEL_SLOTS);
+        node->due  = u32Due;
+        node->next = _slots[slot];
+        _slots[slot] = node;
+        _pending++;
+    }
+
+    /* Sleep until earliest node in wheel is due */
+    void sleepUntilDue()
+    {
+        uint32_t u32Now = micros();
+        uint32_t u32Wait = 0xFFFFFFFFUL;
+        for (uint8_t i = 0; (i < SHT31_WHEEL_SLOTS) && (_pending != 0); i++)
+        {
+            for (TD_SHT31TimerNode *node = _slots[i]; node != nullptr; node = node->next)
+            {
+                int32_t i32Left = (int32_t) (node->due - u32Now);
+                if (i32Left <= 0)
+                {
+                    return;
+                }
+                if ((uint32_t) i32Left < u32Wait)
+                {
+                    u32Wait = (uint32_t) i32Left;
+                }
+            }
+        }
+        if (u32Wait == 0xFFFFFFFFUL)
+        {
+            yield();    /* Nothing scheduled */
+            return;
+        }
+        delay(u32Wait / 1000);
+        delayMicroseconds((unsigned int) (u32Wait % 1000));
+    }
+
+    /* Move expired nodes of slot to ready list, re-arm polled ones */
+    void expire(uint8_t slot, uint32_t u32Now)
+    {
+        TD_SHT31TimerNode **link = &_slots[slot];
+        TD_SHT31TimerNode *rearm = nullptr;
+        while (*link != nullptr)
+        {
+            TD_SHT31TimerNode *node = *link;
+            if ((int32_t) (u32Now - node->due) < 0)
+            {
+                link = &node->next;
+                continue;
+            }
+            *link = node->next;
+            _pending--;
+            if ((node->poll != nullptr) && (node->poll(node) == false))
+            {
+                node->next = rearm;
+                rearm = node;
+                continue;
+            }
+            node->next = nullptr;
+            if (_readyTail == nullptr)
+            {
+                _ready = node;
+            } else
+            {
+                _readyTail->next = node;
+            }
+            _readyTail = node;
+        }
+        while (rearm != nullptr)
+        {
+            TD_SHT31TimerNode *node = rearm;
+            rearm = node->next;
+            schedule(node, u32Now + SHT31_WHEEL_TICK_US);
+        }
+    }
+};
+
+inline TD_SHT31Task::promise_type::~promise_type()
+{
+    if (executor != nullptr)
+    {
+        executor->_live--;
+    }
+}
+
+#endif  //TD_SHT31_HAS_COROUTINES
+
+#endif  //TD_SHT31_COROUTINE_H
@@ -0,0 +1,290 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Linux.cpp
+ * @brief Linux i2c-dev backend for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations.
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+#if defined(TD_SHT31_LINUX)
+
+#include "TD_SHT31Linux.h"
+
+#include <fcntl.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+TwoWire Wire;
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Timing functions, monotonic clock.
+ * ----------------------------------------------------------------------------
+*/
+static uint64_t monotonicMicros()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000ULL + (uint64_t) ts.tv_nsec / 1000;
+}
+
+unsigned long millis()
+{
+    return (unsigned long) (monotonicMicros() / 1000);
+}
+
+unsigned long micros()
+{
+    return (unsigned long) (uint32_t) monotonicMicros();
+}
+
+void delay(unsigned long ms)
+{
+    struct timespec ts;
+    ts.tv_sec  = ms / 1000;
+    ts.tv_nsec = (long) (ms % 1000) * 1000000L;
+    while (nanosleep(&ts, &ts) != 0)
+    {
+        ;   /* Interrupted by signal, sleep remaining time */
+    }
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    struct timespec ts;
+    ts.tv_sec  = us / 1000000;
+    ts.tv_nsec = (long) (us % 1000000) * 1000L;
+    while (nanosleep(&ts, &ts) != 0)
+    {
+        ;
+    }
+}
+
+void yield()
+{
+    sched_yield();
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief TwoWire constructor.
+ * ----------------------------------------------------------------------------
+*/
+TwoWire::TwoWire(const char *device)
+{
+    _device    = device;
+    _fd        = -1;
+    _hook      = NULL;
+    _transfers = 0;
+    _address   = 0;
+    _txLength  = 0;
+    _txHeld    = false;
+    _rxLength  = 0;
+    _rxIndex   = 0;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Functions void begin(), void end(), bool isOpen().
+ * ----------------------------------------------------------------------------
+*/
+void TwoWire::begin()
+{
+    if ((_fd < 0) && (_hook == NULL))
+    {
+        _fd = open(_device, O_RDWR | O_CLOEXEC);
+    }
+}
+
+void TwoWire::end()
+{
+    if (_fd >= 0)
+    {
+        close(_fd);
+        _fd = -1;
+    }
+}
+
+bool TwoWire::isOpen()
+{
+    return ((_fd >= 0) || (_hook != NULL));
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Functions void setDevice(...), void setTransferHook(...).
+ * ----------------------------------------------------------------------------
+*/
+void TwoWire::setDevice(const char *device)
+{
+    _device = device;
+}
+
+void TwoWire::setTransferHook(TD_SHT31LinuxTransfer hook)
+{
+    _hook = hook;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint32_t getTransferCount().
+ * ----------------------------------------------------------------------------
+*/
+uint32_t TwoWire::getTransferCount()
+{
+    uint32_t count = _transfers;
+    _transfers = 0;
+    return count;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Functions beginTransmission and write.
+ * @details Data is buffered until endTransmission.
+ * ----------------------------------------------------------------------------
+*/
+void TwoWire::beginTransmission(uint8_t address)
+{
+    _address  = address;
+    _txLength = 0;
+    _txHeld   = false;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+    if (_txLength >= LINUX_WIRE_BUFFER)
+    {
+        return 0;
+    }
+    _txBuffer[_txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t len)
+{
+    size_t count = 0;
+    while ((count < len) && (write(data[count]) == 1))
+    {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t endTransmission(bool sendStop).
+ * @details Zero length write is address probe.
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+    if (sendStop == false)
+    {
+        _txHeld = true;
+        return 0;
+    }
+
+    struct i2c_msg msg;
+    msg.addr  = _address;
+    msg.flags = 0;
+    msg.len   = _txLength;
+    msg.buf   = _txBuffer;
+    struct i2c_rdwr_ioctl_data data;
+    data.msgs  = &msg;
+    data.nmsgs = 1;
+    return transfer(&data) ? 0 : 2;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t requestFrom(uint8_t address, uint8_t len).
+ * @details Held write to same address is sent as first message of the
+ * same ioctl.
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t len)
+{
+    _rxLength = 0;
+    _rxIndex  = 0;
+    if (len > LINUX_WIRE_BUFFER)
+    {
+        len = LINUX_WIRE_BUFFER;
+    }
+
+    struct i2c_msg msgs[2];
+    uint8_t n = 0;
+    if (_txHeld && (_address == address))
+    {
+        msgs[n].addr  = address;
+        msgs[n].flags = 0;
+        msgs[n].len   = _txLength;
+        msgs[n].buf   = _txBuffer;
+        n++;
+    }
+    _txHeld = false;
+    msgs[n].addr  = address;
+    msgs[n].flags = I2C_M_RD;
+    msgs[n].len   = len;
+    msgs[n].buf   = _rxBuffer;
+    n++;
+
+    struct i2c_rdwr_ioctl_data data;
+    data.msgs  = msgs;
+    data.nmsgs = n;
+    if (transfer(&data) == false)
+    {
+        return 0;
+    }
+    _rxLength = len;
+    return len;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Functions int available(), int read().
+ * ----------------------------------------------------------------------------
+*/
+int TwoWire::available()
+{
+    return _rxLength - _rxIndex;
+}
+
+int TwoWire::read()
+{
+    if (_rxIndex >= _rxLength)
+    {
+        return -1;
+    }
+    return _rxBuffer[_rxIndex++];
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool transfer(struct i2c_rdwr_ioctl_data *data).
+ * @details I2C_RDWR needs no I2C_SLAVE call, address is in each message.
+ * ----------------------------------------------------------------------------
+*/
+bool TwoWire::transfer(struct i2c_rdwr_ioctl_data *data)
+{
+    _transfers++;
+    int retval;
+    if (_hook != NULL)
+    {
+        retval = _hook(data);
+    } else if (_fd >= 0)
+    {
+        retval = ioctl(_fd, I2C_RDWR, data);
+    } else
+    {
+        return false;
+    }
+    return (retval == (int) data->nmsgs);
+}
+
+#endif  //TD_SHT31_LINUX
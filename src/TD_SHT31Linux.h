@@ -0,0 +1,183 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Linux.h
+ * @brief Linux i2c-dev backend for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations.
+ * Build library sources and application with TD_SHT31_LINUX defined,
+ * see examples/TD_SHT31_linux.
+ * Provides TwoWire compatible class over /dev/i2c-N and Arduino timing
+ * functions, so TD_SHT31 runs unchanged on embedded Linux.
+ * Every transaction is one I2C_RDWR ioctl. Write ended with
+ * endTransmission(false) is held and sent with following requestFrom in
+ * the same ioctl (repeated start).
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef TD_SHT31_LINUX_H
+#define TD_SHT31_LINUX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+struct i2c_rdwr_ioctl_data;
+
+/**
+ * @brief Arduino compatibility.
+*/
+typedef uint8_t byte;
+
+#define PROGMEM
+#define pgm_read_byte(p)    (*(const uint8_t *) (p))
+#define pgm_read_word(p)    (*(const uint16_t *) (p))
+
+#define INPUT               0x0
+#define OUTPUT              0x1
+#define INPUT_PULLUP        0x2
+#define LOW                 0x0
+#define HIGH                0x1
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+/** @note No interrupts in user space, transport queue runs in one thread. */
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+/** @note GPIO is not available, bus recovery (RETRY_BUS_RECOVERY) is
+ * not supported. Pins are read as HIGH. */
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return HIGH; }
+
+/**
+ * @brief Default I2C device (Raspberry Pi header pins 3 and 5).
+*/
+#ifndef TD_SHT31_LINUX_DEVICE
+#define TD_SHT31_LINUX_DEVICE   "/dev/i2c-1"
+#endif
+
+#define LINUX_WIRE_BUFFER       32
+
+/**
+ * @brief Transfer hook replacing ioctl(fd, I2C_RDWR, data).
+ * @details For tests without kernel device. Return value as ioctl:
+ * number of messages or -1.
+*/
+typedef int (*TD_SHT31LinuxTransfer)(struct i2c_rdwr_ioctl_data *data);
+
+/**
+ * @class TwoWire.
+ * @brief TwoWire compatible i2c-dev class.
+*/
+class TwoWire
+{
+    public:
+    /**
+     * @brief TwoWire Class forward declaration.
+     * @param *device device path, e.g. "/dev/i2c-1"
+    */
+    TwoWire(const char *device = TD_SHT31_LINUX_DEVICE);
+
+    /**
+     * @brief Open device. Already open device is kept.
+     * @param void
+     * @return void
+     * @note Check result with isOpen.
+    */
+    void begin();
+
+    /**
+     * @brief Close device.
+     * @param void
+     * @return void
+    */
+    void end();
+
+    /**
+     * @brief Return true if device is open or transfer hook is set.
+     * @param void
+     * @return boolean result
+    */
+    bool isOpen();
+
+    /**
+     * @brief Set device path, takes effect in next begin.
+     * @param *device
+     * @return void
+    */
+    void setDevice(const char *device);
+
+    /**
+     * @brief Set transfer hook (test mode) or NULL for ioctl.
+     * @param hook
+     * @return void
+    */
+    void setTransferHook(TD_SHT31LinuxTransfer hook);
+
+    /**
+     * @brief Bus clock is set by device tree, ignored.
+    */
+    void setClock(uint32_t) {}
+
+    /**
+     * @brief Return number of ioctl calls (or hook calls) since last call.
+     * @param void
+     * @return call count
+     * @note When reading counter is cleared.
+    */
+    uint32_t getTransferCount();
+
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t len);
+
+    /**
+     * @brief Send buffered write.
+     * @param sendStop false = hold write for next requestFrom
+     * @return 0 success, 2 NACK or bus error
+    */
+    uint8_t endTransmission(bool sendStop = true);
+
+    /**
+     * @brief Read bytes, combined with held write if any.
+     * @param address
+     * @param len
+     * @return number of bytes read, 0 on error
+    */
+    uint8_t requestFrom(uint8_t address, uint8_t len);
+
+    int available();
+    int read();
+
+    /**
+     * @brief TwoWire Class private declarations.
+    */
+    private:
+    const char *_device;
+    int _fd;
+    TD_SHT31LinuxTransfer _hook;
+    uint32_t _transfers;
+    uint8_t _address;
+    uint8_t _txBuffer[LINUX_WIRE_BUFFER];
+    uint8_t _txLength;
+    bool _txHeld;                       /* Write waits for requestFrom */
+    uint8_t _rxBuffer[LINUX_WIRE_BUFFER];
+    uint8_t _rxLength;
+    uint8_t _rxIndex;
+
+    /**
+     * @brief Execute I2C_RDWR with one or two messages.
+     * @param *data
+     * @return boolean result
+    */
+    bool transfer(struct i2c_rdwr_ioctl_data *data);
+};
+
+extern TwoWire Wire;
+
+#endif  //TD_SHT31_LINUX_H
@@ -0,0 +1,92 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Lock.h
+ * @brief Bus lock for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations.
+ * Share one lock between all TD_SHT31 instances on the same bus with
+ * TD_SHT31::setBusLock. Lock is held during each I2C transfer only, not
+ * during conversion wait, so tasks measuring different sensors overlap
+ * their conversions. Each TD_SHT31 instance itself must be used by one
+ * task at a time.
+ * Implementations:
+ * - TD_SHT31StdMutexLock: std::mutex (Linux with TD_SHT31_LINUX, ESP32 or
+ *   TD_SHT31_STD_MUTEX defined).
+ * - TD_SHT31FreeRTOSLock: FreeRTOS mutex (ESP32 or FreeRTOS.h included
+ *   before this file).
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef TD_SHT31_LOCK_H
+#define TD_SHT31_LOCK_H
+
+#include "TD_SHT31.h"
+
+/**
+ * @class TD_SHT31Lock.
+ * @brief TD_SHT31Lock Class definition (interface).
+*/
+class TD_SHT31Lock
+{
+    public:
+    virtual ~TD_SHT31Lock() {}
+
+    /**
+     * @brief Acquire bus, block until available.
+    */
+    virtual void lock() = 0;
+
+    /**
+     * @brief Release bus.
+    */
+    virtual void unlock() = 0;
+};
+
+#if defined(TD_SHT31_LINUX) || defined(ESP32) || defined(TD_SHT31_STD_MUTEX)
+#include <mutex>
+
+/**
+ * @class TD_SHT31StdMutexLock.
+ * @brief TD_SHT31StdMutexLock Class definition.
+*/
+class TD_SHT31StdMutexLock : public TD_SHT31Lock
+{
+    public:
+    virtual void lock() { _mutex.lock(); }
+    virtual void unlock() { _mutex.unlock(); }
+
+    private:
+    std::mutex _mutex;
+};
+#endif
+
+#if defined(ESP32)
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#define TD_SHT31_HAS_FREERTOS   1
+#elif defined(INC_FREERTOS_H)
+#include "semphr.h"
+#define TD_SHT31_HAS_FREERTOS   1
+#endif
+
+#if defined(TD_SHT31_HAS_FREERTOS)
+/**
+ * @class TD_SHT31FreeRTOSLock.
+ * @brief TD_SHT31FreeRTOSLock Class definition.
+ * @note Mutex is created in constructor, it may be created before
+ * scheduler is started.
+*/
+class TD_SHT31FreeRTOSLock : public TD_SHT31Lock
+{
+    public:
+    TD_SHT31FreeRTOSLock() { _mutex = xSemaphoreCreateMutex(); }
+    virtual ~TD_SHT31FreeRTOSLock() { vSemaphoreDelete(_mutex); }
+    virtual void lock() { xSemaphoreTake(_mutex, portMAX_DELAY); }
+    virtual void unlock() { xSemaphoreGive(_mutex); }
+
+    private:
+    SemaphoreHandle_t _mutex;
+};
+#endif
+
+#endif  //TD_SHT31_LOCK_H
@@ -0,0 +1,233 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Psychro.cpp
+ * @brief Derived psychrometric quantities for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations.
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+
+#include "TD_SHT31Psychro.h"
+#include "TD_SHT31Statistics.h"
+
+/**
+ * @brief Saturation vapour pressure table, -45...85 degC in 1 degC steps.
+ * @details es = 611.2 * exp(17.62 * T / (243.12 + T)) Pa.
+ * Values up to 29 degC (index ES_Q4_COUNT - 1) are Pa * 16, above Pa.
+*/
+#define ES_T_MIN        -4500
+#define ES_T_MAX        8500
+#define ES_COUNT        131
+#define ES_Q4_COUNT     75
+
+/* PROGMEM is read with pgm_read_word on every core (ESP8266 faults otherwise) */
+#define ES_READ(i)      pgm_read_word(&ES_TABLE[i])
+
+static const uint16_t ES_TABLE[ES_COUNT] PROGMEM =
+{
+      179,   199,   222,   247,   274,   304,   337,   374,   414,   457,
+      505,   557,   614,   677,   745,   819,   899,   987,  1082,  1186,
+     1298,  1420,  1551,  1694,  1849,  2015,  2196,  2390,  2600,  2826,
+     3070,  3332,  3614,  3917,  4243,  4592,  4967,  5369,  5800,  6261,
+     6755,  7283,  7847,  8449,  9093,  9779, 10511, 11291, 12122, 13007,
+    13948, 14949, 16013, 17143, 18343, 19616, 20967, 22400, 23917, 25525,
+    27227, 29028, 30932, 32946, 35074, 37322, 39694, 42199, 44840, 47625,
+    50561, 53653, 56910, 60338, 63946,  4234,  4483,  4745,  5020,  5309,
+     5613,  5931,  6265,  6616,  6983,  7367,  7770,  8192,  8634,  9096,
+     9580, 10085, 10614, 11166, 11743, 12345, 12974, 13630, 14315, 15029,
+    15774, 16550, 17359, 18202, 19080, 19993, 20944, 21934, 22963, 24034,
+    25147, 26304, 27506, 28754, 30051, 31398, 32795, 34246, 35751, 37311,
+    38930, 40608, 42347, 44149, 46015, 47949, 49951, 52023, 54168, 56387,
+    58683
+};
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint16_t saturationPressure(int16_t iT).
+ * ----------------------------------------------------------------------------
+*/
+uint16_t TD_SHT31Psychro::saturationPressure(int16_t iT)
+{
+    return (uint16_t) ((vapourPressure(iT, 10000) + 8) >> 4);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function int16_t dewPoint(int16_t iT, int16_t iH).
+ * @details Find table interval containing vapour pressure (binary search)
+ * and interpolate temperature.
+ * ----------------------------------------------------------------------------
+*/
+int16_t TD_SHT31Psychro::dewPoint(int16_t iT, int16_t iH)
+{
+    uint32_t e16 = vapourPressure(iT, iH);
+    if (e16 <= tableValue(0))
+    {
+        return ES_T_MIN;
+    }
+    if (e16 >= tableValue(ES_COUNT - 1))
+    {
+        return ES_T_MAX;
+    }
+
+    uint8_t lo = 0;
+    uint8_t hi = ES_COUNT - 1;
+    while ((uint8_t) (hi - lo) > 1)
+    {
+        uint8_t mid = (lo + hi) >> 1;
+        if (tableValue(mid) <= e16)
+        {
+            lo = mid;
+        } else
+        {
+            hi = mid;
+        }
+    }
+    uint32_t esLo = tableValue(lo);
+    uint32_t esHi = tableValue(hi);
+    uint16_t frac = (uint16_t) (((e16 - esLo) * 100 + ((esHi - esLo) >> 1)) / (esHi - esLo));
+    return ES_T_MIN + (int16_t) lo * 100 + (int16_t) frac;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint16_t absoluteHumidity(int16_t iT, int16_t iH).
+ * @details AH = 2.16679 * e / T (g/m3, e in Pa, T in K).
+ * Calculated as 21668 * e / T (0.01 g/m3, T in 0.01 K).
+ * ----------------------------------------------------------------------------
+*/
+uint16_t TD_SHT31Psychro::absoluteHumidity(int16_t iT, int16_t iH)
+{
+    iT = limitTemperature(iT);
+    uint32_t e16 = vapourPressure(iT, iH);
+    uint32_t tK = (uint32_t) ((int32_t) iT + 27315);
+    /* 21668 / 16 = 1354.25 */
+    return (uint16_t) ((1354UL * e16 + (e16 >> 2) + (tK >> 1)) / tK);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function int32_t enthalpy(int16_t iT, int16_t iH, uint32_t u32Pressure).
+ * @details
+ * - h = 1006 * T + w * (2501000 + 1860 * T) J/kg
+ * - w = 0.622 * e / (p - e), calculated as w * 100000.
+ * ----------------------------------------------------------------------------
+*/
+int32_t TD_SHT31Psychro::enthalpy(int16_t iT, int16_t iH, uint32_t u32Pressure)
+{
+    iT = limitTemperature(iT);
+    uint32_t e16 = vapourPressure(iT, iH);
+    uint32_t e = (e16 + 8) >> 4;
+    if (u32Pressure <= e)
+    {
+        return 0;
+    }
+    /* 62200 / 16 = 3887.5 */
+    uint32_t w5 = (3887UL * e16 + (e16 >> 1)) / (u32Pressure - e);
+    uint32_t hv100 = (uint32_t) (25010L + ((int32_t) iT * 186) / 1000);
+    return ((int32_t) iT * 1006) / 100 + (int32_t) ((w5 * hv100 + 500) / 1000);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function int16_t heatIndex(int16_t iT, int16_t iH).
+ * @details NOAA heat index - Steadman simple formula, Rothfusz regression
+ * when simple result is 80 degF or more, with low/high humidity adjustments.
+ * Calculated in integers, t in 0.001 degF, r in 0.01 %RH, heat index in
+ * 0.000001 degF. Regression coefficients are scaled by 1e8 and evaluated
+ * with Horner in t, every product stays below 2^63 in table range.
+ * ----------------------------------------------------------------------------
+*/
+int16_t TD_SHT31Psychro::heatIndex(int16_t iT, int16_t iH)
+{
+    int32_t t = (int32_t) limitTemperature(iT) * 18 + 32000;
+    int32_t r = (iH < 0) ? 0 : ((iH > 10000) ? 10000 : iH);
+    int64_t hi = 1100LL * t - 10300000LL + 470LL * r;
+
+    if (hi + 1000LL * t >= 160000000LL)
+    {
+        /* Coefficient * 1e8 at R^0, R^1 and R^2, sums in 1e-12 degF */
+        int64_t r2 = (int64_t) r * r;
+        int64_t a = -4237900000LL * 10000 + 1014333127LL * 100 * r - 5481717LL * r2;
+        int64_t b =   204901523LL * 10000 -   22475541LL * 100 * r +   85282LL * r2;
+        int64_t c =     -683783LL * 10000 +     122874LL * 100 * r -     199LL * r2;
+        hi = a + t * (b + t * c / 1000) / 1000;
+        hi = (hi + ((hi < 0) ? -500000 : 500000)) / 1000000;
+
+        if ((r < 1300) && (t > 80000) && (t < 112000))
+        {
+            /* sqrt((17 - |T - 95|) / 17) * 10000 */
+            uint32_t d = (uint32_t) (17000 - ((t > 95000) ? t - 95000 : 95000 - t));
+            uint16_t s = TD_SHT31Statistics::isqrt((uint32_t) ((uint64_t) d * 100000000ULL / 17000));
+            hi -= (int64_t) (1300 - r) * 2500 * s / 10000;
+        } else if ((r > 8500) && (t > 80000) && (t < 87000))
+        {
+            hi += (int64_t) (r - 8500) * (87000 - t) / 5;
+        }
+    }
+
+    /* 0.000001 degF to 0.01 degC: (hi - 32e6) * 5 / 90000 */
+    int64_t n = (hi - 32000000LL) * 5;
+    n = (n + ((n < 0) ? -45000 : 45000)) / 90000;
+    return (n > 32767) ? 32767 : (int16_t) n;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint32_t tableValue(uint8_t index).
+ * ----------------------------------------------------------------------------
+*/
+uint32_t TD_SHT31Psychro::tableValue(uint8_t index)
+{
+    uint32_t value = ES_READ(index);
+    return (index < ES_Q4_COUNT) ? value : (value << 4);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint32_t vapourPressure(int16_t iT, int16_t iH).
+ * @details Product is split so that it stays in 32 bits.
+ * ----------------------------------------------------------------------------
+*/
+uint32_t TD_SHT31Psychro::vapourPressure(int16_t iT, int16_t iH)
+{
+    iT = limitTemperature(iT);
+    if (iH < 0)
+    {
+        iH = 0;
+    } else if (iH > 10000)
+    {
+        iH = 10000;
+    }
+
+    uint16_t offset = (uint16_t) (iT - ES_T_MIN);
+    uint8_t index = offset / 100;
+    uint8_t frac = offset % 100;
+    uint32_t e16 = tableValue(index);
+    if (frac != 0)
+    {
+        e16 += ((tableValue(index + 1) - e16) * frac + 50) / 100;
+    }
+
+    return (e16 / 10000) * (uint16_t) iH + \
+           ((e16 % 10000) * (uint16_t) iH + 5000) / 10000;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function int16_t limitTemperature(int16_t iT).
+ * ----------------------------------------------------------------------------
+*/
+int16_t TD_SHT31Psychro::limitTemperature(int16_t iT)
+{
+    if (iT < ES_T_MIN)
+    {
+        return ES_T_MIN;
+    }
+    if (iT > ES_T_MAX)
+    {
+        return ES_T_MAX;
+    }
+    return iT;
+}
@@ -0,0 +1,114 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Psychro.h
+ * @brief Derived psychrometric quantities for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations. 
+ * Integer functions without exp/log. Saturation vapour pressure (Magnus,
+ * over water) is read from a 1 degree table (PROGMEM) and linearly
+ * interpolated, dew point is found by inverse table lookup.
+ * Inputs are 0.01 degC and 0.01 %RH as returned by TD_SHT31 in CELSIUS.
+ * Valid temperature range -45...85 degC, input is limited to range.
+ * Maximum errors against reference formulas (double precision),
+ * T -45...85 degC, RH 1...100 %RH:
+ * - saturationPressure: 0.2 % + 0.6 Pa
+ * - dewPoint:           0.07 degC (result limited to -45...85 degC)
+ * - absoluteHumidity:   0.2 % + 0.01 g/m3
+ * - enthalpy:           0.05 % + 30 J/kg
+ * - heatIndex:          0.01 degC, NOAA formula in 64-bit integers (no float),
+ *                       result limited to 327.67 degC
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef TD_SHT31_PSYCHRO_H
+#define TD_SHT31_PSYCHRO_H
+
+#if defined(TD_SHT31_LINUX)
+#include "TD_SHT31Linux.h"
+#elif defined(ARDUINO) && ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+/**
+ * @brief Standard atmospheric pressure (Pa).
+*/
+#define PSYCHRO_STD_PRESSURE    101325UL
+
+/**
+ * @class TD_SHT31Psychro.
+ * @brief TD_SHT31Psychro Class definition.
+*/
+class TD_SHT31Psychro
+{
+    public:
+    /**
+     * @brief Saturation vapour pressure over water.
+     * @param iT temperature in 0.01 degC
+     * @return pressure in Pa
+    */
+    static uint16_t saturationPressure(int16_t iT);
+
+    /**
+     * @brief Dew point.
+     * @param iT temperature in 0.01 degC
+     * @param iH humidity in 0.01 %RH
+     * @return dew point in 0.01 degC
+    */
+    static int16_t dewPoint(int16_t iT, int16_t iH);
+
+    /**
+     * @brief Absolute humidity.
+     * @param iT temperature in 0.01 degC
+     * @param iH humidity in 0.01 %RH
+     * @return absolute humidity in 0.01 g/m3
+    */
+    static uint16_t absoluteHumidity(int16_t iT, int16_t iH);
+
+    /**
+     * @brief Specific enthalpy of moist air.
+     * @param iT temperature in 0.01 degC
+     * @param iH humidity in 0.01 %RH
+     * @param u32Pressure air pressure in Pa
+     * @return enthalpy in J/kg (dry air)
+    */
+    static int32_t enthalpy(int16_t iT, int16_t iH,
+                            uint32_t u32Pressure = PSYCHRO_STD_PRESSURE);
+
+    /**
+     * @brief Heat index (NOAA).
+     * @param iT temperature in 0.01 degC
+     * @param iH humidity in 0.01 %RH
+     * @return heat index in 0.01 degC
+    */
+    static int16_t heatIndex(int16_t iT, int16_t iH);
+
+    /**
+     * @brief TD_SHT31Psychro Class private declarations.
+    */
+    private:
+    /**
+     * @brief Return table value in Pa * 16.
+     * @param index table index (0 = -45 degC)
+     * @return pressure in Pa * 16
+    */
+    static uint32_t tableValue(uint8_t index);
+
+    /**
+     * @brief Interpolated vapour pressure.
+     * @param iT temperature in 0.01 degC
+     * @param iH humidity in 0.01 %RH
+     * @return pressure in Pa * 16
+    */
+    static uint32_t vapourPressure(int16_t iT, int16_t iH);
+
+    /**
+     * @brief Limit temperature to table range.
+     * @param iT temperature in 0.01 degC
+     * @return temperature in 0.01 degC
+    */
+    static int16_t limitTemperature(int16_t iT);
+};
+
+#endif  //TD_SHT31_PSYCHRO_H
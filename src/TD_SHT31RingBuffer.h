@@ -0,0 +1,141 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31RingBuffer.h
+ * @brief Sample ring buffer for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations. 
+ * Fixed capacity, no dynamic allocation. Lock-free for one producer
+ * (e.g. timer task or ISR) and one consumer (e.g. loop).
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef TD_SHT31_RING_BUFFER_H
+#define TD_SHT31_RING_BUFFER_H
+
+#if defined(TD_SHT31_LINUX)
+#include "TD_SHT31Linux.h"
+#elif defined(ARDUINO) && ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+/**
+ * @brief Compiler/memory barrier between sample write and index update.
+*/
+#if defined(__AVR__)
+#define SHT31_RING_BARRIER()    __asm__ __volatile__ ("" ::: "memory")
+#else
+#define SHT31_RING_BARRIER()    __sync_synchronize()
+#endif
+
+/**
+ * @brief Timestamped raw sample.
+*/
+struct TD_SHT31Sample
+{
+    uint32_t timestamp;     /* millis() */
+    uint16_t temperature;   /* Raw ticks */
+    uint16_t humidity;      /* Raw ticks */
+};
+
+/**
+ * @class TD_SHT31RingBuffer.
+ * @brief TD_SHT31RingBuffer Class definition.
+ * @details N is capacity, power of two from 2 to 128. Indexes are free
+ * running 8-bit counters, so they are updated atomically also on AVR.
+ * Power of two keeps slot index valid when counter wraps from 255 to 0,
+ * and 128 is largest capacity whose full count fits in 8 bits. Other N
+ * fails to compile on static_assert.
+*/
+template <uint8_t N>
+class TD_SHT31RingBuffer
+{
+    static_assert((N >= 2) && (N <= 128) && ((N & (N - 1)) == 0),
+                  "Capacity must be power of two from 2 to 128");
+
+    public:
+    TD_SHT31RingBuffer() : _head(0), _tail(0) {}
+
+    /**
+     * @brief Append sample (producer).
+     * @param &sample
+     * @return boolean result, false if buffer is full
+    */
+    bool push(const TD_SHT31Sample &sample)
+    {
+        uint8_t head = _head;
+        if ((uint8_t) (head - _tail) >= N)
+        {
+            return false;
+        }
+        _buffer[head & (N - 1)] = sample;
+        SHT31_RING_BARRIER();
+        _head = head + 1;
+        return true;
+    }
+
+    /**
+     * @brief Remove up to max samples (consumer).
+     * @param *samples [out] sample buffer
+     * @param max samples buffer length
+     * @return number of samples removed
+    */
+    uint8_t pop(TD_SHT31Sample *samples, uint8_t max)
+    {
+        uint8_t tail = _tail;
+        uint8_t count = (uint8_t) (_head - tail);
+        SHT31_RING_BARRIER();
+        if (count > max)
+        {
+            count = max;
+        }
+        for (uint8_t i = 0; i < count; i++)
+        {
+            samples[i] = _buffer[(uint8_t) (tail + i) & (N - 1)];
+        }
+        SHT31_RING_BARRIER();
+        _tail = tail + count;
+        return count;
+    }
+
+    /**
+     * @brief Remove one sample (consumer).
+     * @param *sample [out]
+     * @return boolean result, false if buffer is empty
+    */
+    bool pop(TD_SHT31Sample *sample)
+    {
+        return (pop(sample, 1) == 1);
+    }
+
+    /**
+     * @brief Return number of stored samples.
+     * @param void
+     * @return sample count
+    */
+    uint8_t count() const
+    {
+        return (uint8_t) (_head - _tail);
+    }
+
+    /**
+     * @brief Return capacity.
+     * @param void
+     * @return N
+    */
+    uint8_t capacity() const
+    {
+        return N;
+    }
+
+    /**
+     * @brief TD_SHT31RingBuffer Class private declarations.
+    */
+    private:
+    TD_SHT31Sample _buffer[N];
+    volatile uint8_t _head;     /* Written only by producer */
+    volatile uint8_t _tail;     /* Written only by consumer */
+};
+
+#endif  //TD_SHT31_RING_BUFFER_H
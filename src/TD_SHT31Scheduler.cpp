@@ -0,0 +1,240 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Scheduler.cpp
+ * @brief Periodic acquisition scheduler for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations.
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+
+#include "TD_SHT31Scheduler.h"
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief TD_SHT31Scheduler constructor.
+ * ----------------------------------------------------------------------------
+*/
+TD_SHT31Scheduler::TD_SHT31Scheduler()
+{
+    _count     = 0;
+    _running   = 0;
+    _callback  = NULL;
+    _period    = SCHED_EXTERNAL_TICK;
+    _next      = 0;
+    _ticks     = 0;
+    _tickTime  = 0;
+    _ticksSeen = 0;
+    _jitterSum = 0;
+    _jitter.count    = 0;
+    _jitter.overruns = 0;
+    _jitter.min      = 0;
+    _jitter.max      = 0;
+    _jitter.mean     = 0;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool addSensor(TD_SHT31 *sensor, uint16_t u16Command).
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31Scheduler::addSensor(TD_SHT31 *sensor, uint16_t u16Command)
+{
+    if ((sensor == NULL) || (_count >= SHT31_SCHED_MAX_SENSORS))
+    {
+        return false;
+    }
+    _sensors[_count].sensor  = sensor;
+    _sensors[_count].command = u16Command;
+    _sensors[_count].running = false;
+    _count++;
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void setCallback(TD_SHT31ResultCallback callback).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Scheduler::setCallback(TD_SHT31ResultCallback callback)
+{
+    _callback = callback;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void setPeriod(uint32_t u32Period).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Scheduler::setPeriod(uint32_t u32Period)
+{
+    _period = u32Period;
+    _next   = micros();
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void tick().
+ * @details Only trigger time and 8-bit counter are written, counter update
+ * is atomic also on AVR.
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Scheduler::tick()
+{
+    _tickTime = micros();
+    _ticks = _ticks + 1;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool service().
+ * @details
+ * - Start cycle if triggered. Trigger is counted as overrun if previous
+ *   cycle is still running.
+ * - Poll running sensors and deliver completed results.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31Scheduler::service()
+{
+    uint32_t u32Due;
+    if (triggered(&u32Due))
+    {
+        if (_running != 0)
+        {
+            _jitter.overruns++;
+        } else
+        {
+            startCycle(u32Due);
+        }
+    }
+
+    for (uint8_t i = 0; (i < _count) && (_running != 0); i++)
+    {
+        if (_sensors[i].running == false)
+        {
+            continue;
+        }
+        TD_SHT31Measurement result;
+        if (_sensors[i].sensor->pollMeasurement(&result) != MEAS_PENDING)
+        {
+            _sensors[i].running = false;
+            _running--;
+            deliver(i, &result);
+        }
+    }
+    return (_running != 0);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void getJitter(TD_SHT31Jitter *jitter, bool clear).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Scheduler::getJitter(TD_SHT31Jitter *jitter, bool clear)
+{
+    *jitter = _jitter;
+    jitter->mean = (_jitter.count != 0) ? (_jitterSum / _jitter.count) : 0;
+    if (clear)
+    {
+        _jitter.count    = 0;
+        _jitter.overruns = 0;
+        _jitter.min      = 0;
+        _jitter.max      = 0;
+        _jitter.mean     = 0;
+        _jitterSum       = 0;
+    }
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool triggered(uint32_t *u32Due).
+ * @details
+ * - External tick: trigger time is read with interrupts disabled, missed
+ *   ticks are counted as overruns.
+ * - Internal period: next trigger advances by whole periods, missed
+ *   periods are counted as overruns.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31Scheduler::triggered(uint32_t *u32Due)
+{
+    if (_period == SCHED_EXTERNAL_TICK)
+    {
+        noInterrupts();
+        uint8_t ticks = _ticks;
+        uint32_t u32Time = _tickTime;
+        interrupts();
+        if (ticks == _ticksSeen)
+        {
+            return false;
+        }
+        _jitter.overruns += (uint8_t) (ticks - _ticksSeen - 1);
+        _ticksSeen = ticks;
+        *u32Due = u32Time;
+        return true;
+    }
+
+    uint32_t u32Now = micros();
+    if ((int32_t) (u32Now - _next) < 0)
+    {
+        return false;
+    }
+    *u32Due = _next;
+    _next += _period;
+    while ((int32_t) (u32Now - _next) >= 0)
+    {
+        _next += _period;
+        _jitter.overruns++;
+    }
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void startCycle(uint32_t u32Due).
+ * @details Sensor that fails to start is delivered at once with status
+ * of the failed start, sticky errors of the sensor are kept.
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Scheduler::startCycle(uint32_t u32Due)
+{
+    uint32_t u32Jitter = micros() - u32Due;
+    if ((_jitter.count == 0) || (u32Jitter < _jitter.min))
+    {
+        _jitter.min = u32Jitter;
+    }
+    if (u32Jitter > _jitter.max)
+    {
+        _jitter.max = u32Jitter;
+    }
+    if (_jitter.count < 0xFFFF)
+    {
+        _jitter.count++;
+        _jitterSum += u32Jitter;
+    }
+
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        TD_SHT31Measurement result;
+        if (_sensors[i].sensor->startMeasurement(_sensors[i].command, &result) == MEAS_PENDING)
+        {
+            _sensors[i].running = true;
+            _running++;
+        } else
+        {
+            deliver(i, &result);
+        }
+    }
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void deliver(uint8_t index, ...).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Scheduler::deliver(uint8_t index, const TD_SHT31Measurement *result)
+{
+    if (_callback != NULL)
+    {
+        _callback(index, result);
+    }
+}
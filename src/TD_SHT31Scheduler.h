@@ -0,0 +1,162 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Scheduler.h
+ * @brief Periodic acquisition scheduler for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations.
+ * Measurements are triggered either by function tick (e.g. from timer
+ * interrupt) or by internal period. Function service is called from loop,
+ * it starts triggered measurements and polls running ones without
+ * blocking. Results are delivered with callback. Start jitter (trigger to
+ * command written) is recorded.
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef TD_SHT31_SCHEDULER_H
+#define TD_SHT31_SCHEDULER_H
+
+#include "TD_SHT31.h"
+
+/**
+ * @brief Maximum number of sensors.
+ * @details Change with build flag, e.g. -DSHT31_SCHED_MAX_SENSORS=16, so
+ * that library source and sketch see the same class layout. Define in
+ * sketch does not reach library source.
+*/
+#ifndef SHT31_SCHED_MAX_SENSORS
+#define SHT31_SCHED_MAX_SENSORS 8
+#endif
+
+/**
+ * @brief Period of externally triggered scheduler.
+ * @details Used in function setPeriod.
+*/
+#define SCHED_EXTERNAL_TICK     0
+
+/**
+ * @brief Result callback.
+ * @param index sensor index (order of addSensor calls)
+ * @param *result measurement, check result->ok()
+ * @note Called from function service, not from interrupt.
+*/
+typedef void (*TD_SHT31ResultCallback)(uint8_t index, const TD_SHT31Measurement *result);
+
+/**
+ * @brief Start jitter statistics in microseconds.
+*/
+struct TD_SHT31Jitter
+{
+    uint16_t count;         /* Started cycles */
+    uint16_t overruns;      /* Triggers skipped, previous cycle running */
+    uint32_t min;
+    uint32_t max;
+    uint32_t mean;
+};
+
+/**
+ * @class TD_SHT31Scheduler.
+ * @brief TD_SHT31Scheduler Class definition.
+*/
+class TD_SHT31Scheduler
+{
+    public:
+    /**
+     * @brief TD_SHT31Scheduler Class forward declaration.
+    */
+    TD_SHT31Scheduler();
+
+    /**
+     * @brief Add sensor.
+     * @param *sensor initialized TD_SHT31 instance
+     * @param u16Command single shot command
+     * @return boolean result
+    */
+    bool addSensor(TD_SHT31 *sensor, uint16_t u16Command);
+
+    /**
+     * @brief Set result callback.
+     * @param callback hook or NULL
+     * @return void
+    */
+    void setCallback(TD_SHT31ResultCallback callback);
+
+    /**
+     * @brief Set trigger period.
+     * @param u32Period period in microseconds or SCHED_EXTERNAL_TICK
+     * @return void
+     * @details Internal period is phase locked, late cycles do not shift
+     * following ones. First cycle is triggered at once.
+    */
+    void setPeriod(uint32_t u32Period);
+
+    /**
+     * @brief Trigger measurement cycle.
+     * @param void
+     * @return void
+     * @note Interrupt safe. Does not access I2C.
+    */
+    void tick();
+
+    /**
+     * @brief Start triggered cycle and poll running measurements.
+     * @param void
+     * @return true while measurements are running
+     * @note Call from loop as often as possible.
+    */
+    bool service();
+
+    /**
+     * @brief Get jitter statistics.
+     * @param *jitter [out]
+     * @param clear clear statistics after reading
+     * @return void
+    */
+    void getJitter(TD_SHT31Jitter *jitter, bool clear);
+
+    /**
+     * @brief TD_SHT31Scheduler Class private declarations.
+    */
+    private:
+    struct Entry
+    {
+        TD_SHT31 *sensor;
+        uint16_t command;
+        bool running;
+    };
+
+    Entry _sensors[SHT31_SCHED_MAX_SENSORS];
+    uint8_t _count;
+    uint8_t _running;
+    TD_SHT31ResultCallback _callback;
+    uint32_t _period;
+    uint32_t _next;                 /* Next internal trigger, micros() */
+    volatile uint8_t _ticks;        /* Written only by tick */
+    volatile uint32_t _tickTime;    /* Written only by tick */
+    uint8_t _ticksSeen;
+    uint32_t _jitterSum;
+    TD_SHT31Jitter _jitter;
+
+    /**
+     * @brief Return due time of pending trigger.
+     * @param *u32Due [out] trigger time, micros()
+     * @return boolean result, false if no trigger is pending
+    */
+    bool triggered(uint32_t *u32Due);
+
+    /**
+     * @brief Start measurement on all sensors.
+     * @param u32Due trigger time, micros()
+     * @return void
+    */
+    void startCycle(uint32_t u32Due);
+
+    /**
+     * @brief Deliver result to callback.
+     * @param index sensor index
+     * @param *result
+     * @return void
+    */
+    void deliver(uint8_t index, const TD_SHT31Measurement *result);
+};
+
+#endif  //TD_SHT31_SCHEDULER_H
@@ -0,0 +1,220 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Statistics.cpp
+ * @brief Streaming statistics for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations.
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+
+#include "TD_SHT31Statistics.h"
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief TD_SHT31Statistics constructor.
+ * ----------------------------------------------------------------------------
+*/
+TD_SHT31Statistics::TD_SHT31Statistics(uint16_t window)
+{
+    _window = window;
+    clear();
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void setWindow(uint16_t window).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Statistics::setWindow(uint16_t window)
+{
+    _window = window;
+    clear();
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void add(int16_t iT, int16_t iH).
+ * @details Latch summary and restart when tumbling window is complete.
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Statistics::add(int16_t iT, int16_t iH)
+{
+    if (_count == 0xFFFF)
+    {
+        return;
+    }
+    addMoment(&_t, iT, _count == 0);
+    addMoment(&_h, iH, _count == 0);
+    _count++;
+
+    if ((_window != STATS_CUMULATIVE) && (_count >= _window))
+    {
+        getSummary(&_latched);
+        _windowReady = true;
+        _count = 0;
+    }
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void clear().
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Statistics::clear()
+{
+    _count = 0;
+    _t.min = _t.max = 0;
+    _t.sum = 0;
+    _t.sumSq = 0;
+    _h = _t;
+    _windowReady = false;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint16_t count().
+ * ----------------------------------------------------------------------------
+*/
+uint16_t TD_SHT31Statistics::count() const
+{
+    return _count;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool getSummary(TD_SHT31Summary *summary).
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31Statistics::getSummary(TD_SHT31Summary *summary) const
+{
+    summary->count = _count;
+    summarize(&_t, _count, &summary->tMin, &summary->tMax, &summary->tMean,
+              &summary->tVariance, &summary->tDeviation);
+    summarize(&_h, _count, &summary->hMin, &summary->hMax, &summary->hMean,
+              &summary->hVariance, &summary->hDeviation);
+    return (_count != 0);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool getWindow(TD_SHT31Summary *summary).
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31Statistics::getWindow(TD_SHT31Summary *summary)
+{
+    if (_windowReady == false)
+    {
+        return false;
+    }
+    *summary = _latched;
+    _windowReady = false;
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint16_t isqrt(uint32_t value).
+ * @details Bitwise method, 16 iterations, no division.
+ * ----------------------------------------------------------------------------
+*/
+uint16_t TD_SHT31Statistics::isqrt(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint16_t) root;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void remove(int16_t iT, int16_t iH).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Statistics::remove(int16_t iT, int16_t iH)
+{
+    if (_count == 0)
+    {
+        return;
+    }
+    _t.sum   -= iT;
+    _t.sumSq -= (int32_t) iT * iT;
+    _h.sum   -= iH;
+    _h.sumSq -= (int32_t) iH * iH;
+    _count--;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void addMoment(Moments *m, int16_t value, bool first).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Statistics::addMoment(Moments *m, int16_t value, bool first)
+{
+    if (first)
+    {
+        m->min   = value;
+        m->max   = value;
+        m->sum   = 0;
+        m->sumSq = 0;
+    } else if (value < m->min)
+    {
+        m->min = value;
+    } else if (value > m->max)
+    {
+        m->max = value;
+    }
+    m->sum   += value;
+    m->sumSq += (int32_t) value * value;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void summarize(...).
+ * @details
+ * - Mean is rounded to nearest.
+ * - Variance = (n * sumSq - sum^2) / (n * (n - 1)), exact in 64 bits.
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Statistics::summarize(const Moments *m, uint16_t count, int16_t *min,
+    int16_t *max, int16_t *mean, uint32_t *variance, uint16_t *deviation)
+{
+    *variance  = 0;
+    *deviation = 0;
+    if (count == 0)
+    {
+        *min  = 0;
+        *max  = 0;
+        *mean = 0;
+        return;
+    }
+    *min = m->min;
+    *max = m->max;
+
+    int32_t half = count / 2;
+    *mean = (int16_t) ((m->sum >= 0) ? (m->sum + half) / count
+                                     : (m->sum - half) / count);
+    if (count < 2)
+    {
+        return;
+    }
+    int64_t numerator = (int64_t) count * m->sumSq - (int64_t) m->sum * m->sum;
+    uint64_t result = (uint64_t) numerator / ((uint32_t) count * (count - 1));
+    *variance  = (result > 0xFFFFFFFFUL) ? 0xFFFFFFFFUL : (uint32_t) result;
+    *deviation = isqrt(*variance);
+}
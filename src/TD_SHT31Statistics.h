@@ -0,0 +1,245 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Statistics.h
+ * @brief Streaming statistics for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations.
+ * Count, min, max, mean and variance of temperature and humidity in
+ * 0.01 units without storing samples. Integer sums are exact, so results
+ * do not depend on sample order. No dynamic allocation.
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef TD_SHT31_STATISTICS_H
+#define TD_SHT31_STATISTICS_H
+
+#if defined(TD_SHT31_LINUX)
+#include "TD_SHT31Linux.h"
+#elif defined(ARDUINO) && ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+/**
+ * @brief Statistics window.
+ * @details Used in constructor and function setWindow.
+ * - STATS_CUMULATIVE: accumulate until clear.
+ * - 1...65535: tumbling window, summary is latched and accumulation
+ *   restarts after window samples.
+*/
+#define STATS_CUMULATIVE    0
+
+/**
+ * @brief Statistics summary.
+ * @details Values in 0.01 units, variance in 0.0001 units^2 (sample
+ * variance, n - 1). Variance and deviation are 0 if count is below 2.
+*/
+struct TD_SHT31Summary
+{
+    uint16_t count;
+    int16_t tMin;
+    int16_t tMax;
+    int16_t tMean;
+    uint32_t tVariance;
+    uint16_t tDeviation;
+    int16_t hMin;
+    int16_t hMax;
+    int16_t hMean;
+    uint32_t hVariance;
+    uint16_t hDeviation;
+};
+
+/**
+ * @class TD_SHT31Statistics.
+ * @brief TD_SHT31Statistics Class definition.
+ * @details Attach to sensor with TD_SHT31::setStatistics to feed every
+ * decoded measurement, or call add directly.
+*/
+class TD_SHT31Statistics
+{
+    public:
+    /**
+     * @brief TD_SHT31Statistics Class forward declaration.
+     * @param window STATS_CUMULATIVE or tumbling window length in samples
+    */
+    TD_SHT31Statistics(uint16_t window = STATS_CUMULATIVE);
+
+    /**
+     * @brief Set window length, clears statistics.
+     * @param window STATS_CUMULATIVE or tumbling window length in samples
+     * @return void
+    */
+    virtual void setWindow(uint16_t window);
+
+    /**
+     * @brief Add sample.
+     * @param iT temperature in 0.01 degrees
+     * @param iH humidity in 0.01 %RH
+     * @return void
+     * @note In cumulative mode samples are ignored after 65535 samples.
+    */
+    virtual void add(int16_t iT, int16_t iH);
+
+    /**
+     * @brief Clear statistics and latched window.
+     * @param void
+     * @return void
+    */
+    virtual void clear();
+
+    /**
+     * @brief Return number of samples in current accumulation.
+     * @param void
+     * @return sample count
+    */
+    uint16_t count() const;
+
+    /**
+     * @brief Get summary of current accumulation.
+     * @param *summary [out]
+     * @return boolean result, false if there are no samples
+    */
+    bool getSummary(TD_SHT31Summary *summary) const;
+
+    /**
+     * @brief Get summary of latest completed tumbling window.
+     * @param *summary [out]
+     * @return boolean result, true once per completed window
+    */
+    bool getWindow(TD_SHT31Summary *summary);
+
+    /**
+     * @brief Integer square root.
+     * @param value
+     * @return floor(sqrt(value))
+    */
+    static uint16_t isqrt(uint32_t value);
+
+    /**
+     * @brief TD_SHT31Statistics Class protected declarations.
+    */
+    protected:
+    /**
+     * @brief Moments of one quantity.
+    */
+    struct Moments
+    {
+        int16_t min;
+        int16_t max;
+        int32_t sum;
+        int64_t sumSq;
+    };
+
+    /**
+     * @brief Remove sample from sums (rolling window).
+     * @param iT temperature in 0.01 degrees
+     * @param iH humidity in 0.01 %RH
+     * @return void
+     * @note Min and max are not updated, see TD_SHT31RollingStatistics.
+    */
+    void remove(int16_t iT, int16_t iH);
+
+    static void addMoment(Moments *m, int16_t value, bool first);
+    static void summarize(const Moments *m, uint16_t count, int16_t *min,
+        int16_t *max, int16_t *mean, uint32_t *variance, uint16_t *deviation);
+
+    uint16_t _window;
+    uint16_t _count;
+    Moments _t;
+    Moments _h;
+    bool _windowReady;
+    TD_SHT31Summary _latched;
+};
+
+/**
+ * @class TD_SHT31RollingStatistics.
+ * @brief TD_SHT31RollingStatistics Class definition.
+ * @details Statistics over last N samples, N from 2 to 255. Sums are
+ * updated in O(1), min and max are rescanned only when the evicted sample
+ * was an extreme. Stores N samples (4 * N bytes).
+*/
+template <uint8_t N>
+class TD_SHT31RollingStatistics : public TD_SHT31Statistics
+{
+    static_assert(N >= 2, "Window must be at least 2 samples");
+
+    public:
+    TD_SHT31RollingStatistics() : TD_SHT31Statistics(STATS_CUMULATIVE), _next(0) {}
+
+    /**
+     * @brief Clear statistics, window stays N samples.
+     * @param window ignored, tumbling window would break the sample ring
+     * @return void
+    */
+    virtual void setWindow(uint16_t window)
+    {
+        (void) window;
+        clear();
+    }
+
+    /**
+     * @brief Add sample, evict oldest if window is full.
+     * @param iT temperature in 0.01 degrees
+     * @param iH humidity in 0.01 %RH
+     * @return void
+    */
+    virtual void add(int16_t iT, int16_t iH)
+    {
+        if (_count < N)
+        {
+            TD_SHT31Statistics::add(iT, iH);
+        } else
+        {
+            int16_t oldT = _samples[_next][0];
+            int16_t oldH = _samples[_next][1];
+            remove(oldT, oldH);
+            _samples[_next][0] = iT;
+            _samples[_next][1] = iH;
+            TD_SHT31Statistics::add(iT, iH);
+            if ((oldT == _t.min) || (oldT == _t.max) ||
+                (oldH == _h.min) || (oldH == _h.max))
+            {
+                rescan();
+            }
+            _next = (uint8_t) ((_next + 1) % N);
+            return;
+        }
+        _samples[_next][0] = iT;
+        _samples[_next][1] = iH;
+        _next = (uint8_t) ((_next + 1) % N);
+    }
+
+    /**
+     * @brief Clear statistics.
+     * @param void
+     * @return void
+    */
+    virtual void clear()
+    {
+        TD_SHT31Statistics::clear();
+        _next = 0;
+    }
+
+    /**
+     * @brief TD_SHT31RollingStatistics Class private declarations.
+    */
+    private:
+    void rescan()
+    {
+        _t.min = _t.max = _samples[0][0];
+        _h.min = _h.max = _samples[0][1];
+        for (uint8_t i = 1; i < N; i++)
+        {
+            if (_samples[i][0] < _t.min) _t.min = _samples[i][0];
+            if (_samples[i][0] > _t.max) _t.max = _samples[i][0];
+            if (_samples[i][1] < _h.min) _h.min = _samples[i][1];
+            if (_samples[i][1] > _h.max) _h.max = _samples[i][1];
+        }
+    }
+
+    int16_t _samples[N][2];
+    uint8_t _next;
+};
+
+#endif  //TD_SHT31_STATISTICS_H
@@ -0,0 +1,56 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Transfer.h
+ * @brief I2C transfer descriptor for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations.
+ * Descriptor is shared by TD_SHT31 (one per instance) and transaction
+ * queue (TD_SHT31Transport.h).
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef TD_SHT31_TRANSFER_H
+#define TD_SHT31_TRANSFER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Transfer states.
+*/
+#define XFER_IDLE           0
+#define XFER_QUEUED         1
+#define XFER_BUSY           2
+#define XFER_DONE           3
+
+struct TD_SHT31Transfer;
+
+/**
+ * @brief Transfer completion callback.
+ * @param *transfer completed transfer, result is set
+ * @note Called from function complete, i.e. from interrupt with
+ * interrupt driven backends.
+*/
+typedef void (*TD_SHT31TransferCallback)(TD_SHT31Transfer *transfer);
+
+/**
+ * @brief Transfer descriptor.
+ * @details Write of writeLen bytes followed by read of readLen bytes.
+ * Write and read are combined with repeated start, write alone ends with
+ * STOP. Both lengths 0 is address probe. Initialize state to XFER_IDLE,
+ * descriptor must stay valid until state is XFER_DONE.
+*/
+struct TD_SHT31Transfer
+{
+    uint8_t address;
+    uint8_t writeLen;                   /* 0...2 */
+    uint8_t readLen;
+    uint8_t writeData[2];
+    uint8_t *readData;                  /* readLen bytes */
+    TD_SHT31TransferCallback callback;  /* Or NULL */
+    void *context;                      /* For callback */
+    volatile uint8_t state;
+    volatile int result;                /* NO_ERROR or TD_SHT31 error code */
+    TD_SHT31Transfer *next;             /* Queue link */
+};
+
+#endif  //TD_SHT31_TRANSFER_H
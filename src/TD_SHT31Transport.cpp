@@ -0,0 +1,177 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Transport.cpp
+ * @brief I2C transaction queue for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations.
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+
+#include "TD_SHT31Transport.h"
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief TD_SHT31Transport constructor.
+ * ----------------------------------------------------------------------------
+*/
+TD_SHT31Transport::TD_SHT31Transport()
+{
+    _head        = NULL;
+    _tail        = NULL;
+    _dispatching = false;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool submit(TD_SHT31Transfer *transfer).
+ * @details Queue is updated with interrupts disabled because complete may
+ * be called from interrupt.
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31Transport::submit(TD_SHT31Transfer *transfer)
+{
+    if ((transfer->state == XFER_QUEUED) || (transfer->state == XFER_BUSY))
+    {
+        return false;
+    }
+    transfer->state  = XFER_QUEUED;
+    transfer->result = NO_ERROR;
+    transfer->next   = NULL;
+
+    noInterrupts();
+    if (_tail == NULL)
+    {
+        _head = transfer;
+    } else
+    {
+        _tail->next = transfer;
+    }
+    _tail = transfer;
+    interrupts();
+
+    dispatch();
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void complete(TD_SHT31Transfer *transfer, int result).
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Transport::complete(TD_SHT31Transfer *transfer, int result)
+{
+    noInterrupts();
+    if (_head == transfer)
+    {
+        _head = transfer->next;
+        if (_head == NULL)
+        {
+            _tail = NULL;
+        }
+    }
+    interrupts();
+
+    transfer->result = result;
+    transfer->state  = XFER_DONE;
+    if (transfer->callback != NULL)
+    {
+        transfer->callback(transfer);
+    }
+    dispatch();
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool isIdle().
+ * ----------------------------------------------------------------------------
+*/
+bool TD_SHT31Transport::isIdle()
+{
+    return (_head == NULL);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void dispatch().
+ * @details Loop instead of recursion: blocking backend completes inside
+ * start, which calls dispatch again. Nested call returns at once and the
+ * outer loop starts next transfer.
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31Transport::dispatch()
+{
+    noInterrupts();
+    if (_dispatching)
+    {
+        interrupts();
+        return;
+    }
+    _dispatching = true;
+    interrupts();
+
+    while (true)
+    {
+        noInterrupts();
+        TD_SHT31Transfer *transfer = _head;
+        if ((transfer == NULL) || (transfer->state != XFER_QUEUED))
+        {
+            _dispatching = false;
+            interrupts();
+            return;
+        }
+        transfer->state = XFER_BUSY;
+        interrupts();
+        start(transfer);
+    }
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief TD_SHT31WireTransport constructor.
+ * ----------------------------------------------------------------------------
+*/
+TD_SHT31WireTransport::TD_SHT31WireTransport(TwoWire *wire)
+{
+    _wire = wire;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void start(TD_SHT31Transfer *transfer).
+ * @details Execute transfer at once, errors as in TD_SHT31.
+ * ----------------------------------------------------------------------------
+*/
+void TD_SHT31WireTransport::start(TD_SHT31Transfer *transfer)
+{
+    if ((transfer->writeLen != 0) || (transfer->readLen == 0))
+    {
+        _wire->beginTransmission(transfer->address);
+        if ((transfer->writeLen != 0) && \
+            (_wire->write(transfer->writeData, transfer->writeLen) != transfer->writeLen))
+        {
+            complete(transfer, ERROR_WRITE_LEN);
+            return;
+        }
+        /* Repeated start if read follows */
+        if (_wire->endTransmission(transfer->readLen == 0) != 0)
+        {
+            complete(transfer, ERROR_END_TRANSMISSION);
+            return;
+        }
+    }
+
+    if (transfer->readLen != 0)
+    {
+        if (_wire->requestFrom(transfer->address, transfer->readLen) != transfer->readLen)
+        {
+            complete(transfer, ERROR_REQUEST_LEN);
+            return;
+        }
+        for (uint8_t i = 0; i < transfer->readLen; i++)
+        {
+            transfer->readData[i] = _wire->read();
+        }
+    }
+    complete(transfer, NO_ERROR);
+}
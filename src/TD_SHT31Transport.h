@@ -0,0 +1,111 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file TD_SHT31Transport.h
+ * @brief I2C transaction queue for TD_SHT31 library.
+ * @details Written by Honee52 for Technode Design (info@technode.fi).
+ * You may use this library as it is or change it without limitations.
+ * Transfers are described by TD_SHT31Transfer descriptors and executed in
+ * submit order by backend. TD_SHT31WireTransport executes transfers at
+ * once with TwoWire (blocking). Interrupt or DMA driven backend derives
+ * from TD_SHT31Transport, starts transfer in function start and calls
+ * function complete when hardware is done.
+ * No dynamic allocation, descriptors are linked into the queue.
+ * Beerware license.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef TD_SHT31_TRANSPORT_H
+#define TD_SHT31_TRANSPORT_H
+
+#include "TD_SHT31.h"
+#include "TD_SHT31Transfer.h"
+
+/**
+ * @class TD_SHT31Transport.
+ * @brief TD_SHT31Transport Class definition (backend base).
+*/
+class TD_SHT31Transport
+{
+    public:
+    /**
+     * @brief TD_SHT31Transport Class forward declaration.
+    */
+    TD_SHT31Transport();
+
+    /**
+     * @brief Queue transfer, start it if bus is idle.
+     * @param *transfer descriptor
+     * @return boolean result, false if descriptor is already queued
+    */
+    bool submit(TD_SHT31Transfer *transfer);
+
+    /**
+     * @brief Complete transfer started by backend.
+     * @param *transfer transfer at head of queue
+     * @param result NO_ERROR or TD_SHT31 error code
+     * @return void
+     * @note Interrupt safe. Next queued transfer is started.
+    */
+    void complete(TD_SHT31Transfer *transfer, int result);
+
+    /**
+     * @brief Return true if no transfer is queued or running.
+     * @param void
+     * @return boolean result
+    */
+    bool isIdle();
+
+    /**
+     * @brief TD_SHT31Transport Class protected declarations.
+    */
+    protected:
+    /**
+     * @brief Start transfer (backend).
+     * @param *transfer
+     * @return void
+     * @note Backend must call complete exactly once, also on failure.
+    */
+    virtual void start(TD_SHT31Transfer *transfer) = 0;
+
+    /**
+     * @brief TD_SHT31Transport Class private declarations.
+    */
+    private:
+    TD_SHT31Transfer * volatile _head;
+    TD_SHT31Transfer * volatile _tail;
+    volatile bool _dispatching;
+
+    /**
+     * @brief Start queued transfers until one is left running.
+     * @param void
+     * @return void
+    */
+    void dispatch();
+};
+
+/**
+ * @class TD_SHT31WireTransport.
+ * @brief TD_SHT31WireTransport Class definition (blocking TwoWire backend).
+*/
+class TD_SHT31WireTransport : public TD_SHT31Transport
+{
+    public:
+    /**
+     * @brief TD_SHT31WireTransport Class forward declaration.
+     * @param *wire initialized TwoWire instance
+    */
+    TD_SHT31WireTransport(TwoWire *wire);
+
+    /**
+     * @brief TD_SHT31WireTransport Class protected declarations.
+    */
+    protected:
+    virtual void start(TD_SHT31Transfer *transfer);
+
+    /**
+     * @brief TD_SHT31WireTransport Class private declarations.
+    */
+    private:
+    TwoWire *_wire;
+};
+
+#endif  //TD_SHT31_TRANSPORT_H
@@ -0,0 +1,25 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file bench.cpp
+ * @brief TD_SHT31_benchmark sketch on host, one pass of loop().
+ * @details Sensors 0x44 and 0x45 are SHT31Model instances. Times are
+ * virtual: bus time as modelled by host TwoWire plus HOST_CALL_US per
+ * micros() call, so they track bus traffic and call counts, not CPU speed.
+ * Records without bus (psychro, crc8, decode) are not meaningful on host.
+ * ----------------------------------------------------------------------------
+*/
+#include "Arduino.h"
+#include "SHT31Model.h"
+
+#include "../examples/TD_SHT31_benchmark/TD_SHT31_benchmark.ino"
+
+int main()
+{
+    static SHT31Model a(0x44);
+    static SHT31Model b(0x45);
+    Wire.attach(&a);
+    Wire.attach(&b);
+    setup();
+    loop();
+    return 0;
+}
@@ -0,0 +1,72 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file Arduino.h
+ * @brief Host stand-in of Arduino core for TD_SHT31 tests.
+ * @details Virtual clock: delay, delayMicroseconds and bus traffic advance
+ * time, every micros() call advances it by HOST_CALL_US to model CPU time
+ * of polling loops. No real waiting.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+
+#define PROGMEM
+#define pgm_read_byte(p)    (*(const uint8_t *) (p))
+#define pgm_read_word(p)    (*(const uint16_t *) (p))
+
+#define INPUT               0x0
+#define OUTPUT              0x1
+#define INPUT_PULLUP        0x2
+#define LOW                 0x0
+#define HIGH                0x1
+
+#define HOST_CALL_US        1
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+/**
+ * @brief Called from pinMode and digitalWrite, e.g. to check bus recovery.
+*/
+extern void (*hostPinHook)(uint8_t pin);
+
+inline void pinMode(uint8_t pin, uint8_t) { if (hostPinHook != NULL) hostPinHook(pin); }
+inline void digitalWrite(uint8_t pin, uint8_t) { if (hostPinHook != NULL) hostPinHook(pin); }
+inline int digitalRead(uint8_t) { return HIGH; }
+
+/**
+ * @brief Virtual clock control.
+*/
+uint64_t hostTime();                    /* Microseconds */
+void hostSetTime(uint64_t u64Time);
+void hostAdvance(uint32_t u32Micros);
+
+/**
+ * @brief Blocking call accounting, delay and delayMicroseconds calls.
+*/
+extern uint32_t hostDelayCalls;
+extern uint64_t hostDelayMicros;
+
+/**
+ * @brief Called from yield(), e.g. to complete asynchronous transfers.
+*/
+extern void (*hostYieldHook)();
+extern uint32_t hostYieldCalls;
+
+#include "HardwareSerial.h"
+
+#endif  //HOST_ARDUINO_H
@@ -0,0 +1,58 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file HardwareSerial.h
+ * @brief Host stand-in of Serial for example sketches, prints to stdout.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef HOST_HARDWARE_SERIAL_H
+#define HOST_HARDWARE_SERIAL_H
+
+#include <stdio.h>
+
+#define DEC                 10
+#define HEX                 16
+#define BIN                 2
+
+class HardwareSerial
+{
+    public:
+    void begin(unsigned long) {}
+    operator bool() { return true; }
+
+    void print(const char *s) { fputs(s, stdout); }
+    void print(char c) { putchar(c); }
+    void print(int v, int base = DEC) { print((long) v, base); }
+    void print(unsigned int v, int base = DEC) { print((unsigned long) v, base); }
+    void print(long v, int base = DEC)
+    {
+        if ((base == DEC) && (v < 0))
+        {
+            putchar('-');
+            print((unsigned long) -v, base);
+        } else
+        {
+            print((unsigned long) v, base);
+        }
+    }
+    void print(unsigned long v, int base = DEC)
+    {
+        char buffer[8 * sizeof(v) + 1];
+        char *p = &buffer[sizeof(buffer) - 1];
+        *p = '\0';
+        do
+        {
+            *--p = "0123456789ABCDEF"[v % base];
+            v /= base;
+        } while (v != 0);
+        fputs(p, stdout);
+    }
+    void print(double v, int digits = 2) { printf("%.*f", digits, v); }
+
+    template <typename T> void println(T v) { print(v); putchar('\n'); }
+    template <typename T> void println(T v, int arg) { print(v, arg); putchar('\n'); }
+    void println() { putchar('\n'); }
+};
+
+extern HardwareSerial Serial;
+
+#endif  //HOST_HARDWARE_SERIAL_H
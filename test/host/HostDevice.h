@@ -0,0 +1,44 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file HostDevice.h
+ * @brief Simulated I2C slave interface for TD_SHT31 tests.
+ * @details No Arduino dependencies, used with host TwoWire and with
+ * transfer hook of Linux backend.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef HOST_DEVICE_H
+#define HOST_DEVICE_H
+
+#include <stdint.h>
+
+/**
+ * @class HostDevice.
+ * @brief Simulated I2C slave.
+*/
+class HostDevice
+{
+    public:
+    HostDevice(uint8_t address) : address(address) {}
+    virtual ~HostDevice() {}
+
+    /**
+     * @brief Addressed write, len 0 is address probe.
+     * @return true if address and all bytes were ACKed
+    */
+    virtual bool write(const uint8_t *data, uint8_t len) = 0;
+
+    /**
+     * @brief Microseconds SCL is held low after read header.
+    */
+    virtual uint32_t stretch() { return 0; }
+
+    /**
+     * @brief Addressed read.
+     * @return true if address was ACKed
+    */
+    virtual bool read(uint8_t *data, uint8_t len) = 0;
+
+    uint8_t address;
+};
+
+#endif  //HOST_DEVICE_H
@@ -0,0 +1,328 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file SHT31Model.cpp
+ * @brief Simulated SHT31 for TD_SHT31 tests.
+ * ----------------------------------------------------------------------------
+*/
+#include "SHT31Model.h"
+
+#include <stddef.h>
+
+unsigned long micros();
+
+#define PENDING_NONE        0
+#define PENDING_DATA        1
+#define PENDING_FETCH       2
+#define PENDING_STATUS      3
+
+#define BREAK_US            1000
+#define SOFT_RESET_US       1500
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief SHT31Model constructor.
+ * @details Typical conversion times - refer datasheet page 7.
+ * ----------------------------------------------------------------------------
+*/
+SHT31Model::SHT31Model(uint8_t address) : HostDevice(address)
+{
+    conversionUs[0] = 12500;
+    conversionUs[1] = 4500;
+    conversionUs[2] = 2500;
+    corruptCrc  = 0;
+    nackNext    = 0;
+    nackWrites  = 0;
+    status      = MODEL_STATUS_RESET;
+    lastCommand = 0;
+    commands    = 0;
+    conversions = 0;
+    busyNacks   = 0;
+    dataReads   = 0;
+    resets      = 0;
+    _mode       = MODEL_IDLE;
+    _pending    = PENDING_NONE;
+    _stretching = false;
+    _start      = 0;
+    _duration   = 0;
+    _period     = 0;
+    _fetched    = 0;
+    _busyUntil  = 0;
+    _busy       = false;
+    set(23.45f, 45.67f);
+}
+
+void SHT31Model::setRaw(uint16_t u16T, uint16_t u16H)
+{
+    rawT = u16T;
+    rawH = u16H;
+}
+
+void SHT31Model::set(float celsius, float humidity)
+{
+    setRaw((uint16_t) ((celsius + 45.0f) * 65535.0f / 175.0f + 0.5f),
+           (uint16_t) (humidity * 65535.0f / 100.0f + 0.5f));
+}
+
+uint8_t SHT31Model::crc8(const uint8_t *data, uint8_t len)
+{
+    uint8_t crc = 0xFF;
+    for (uint8_t j = 0; j < len; j++)
+    {
+        crc ^= data[j];
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            crc = (crc & 0x80) ? (uint8_t) ((crc << 1) ^ 0x31) : (uint8_t) (crc << 1);
+        }
+    }
+    return crc;
+}
+
+/* Reset or break in progress */
+bool SHT31Model::isBusy(uint32_t u32Now)
+{
+    if (_busy && ((int32_t) (u32Now - _busyUntil) >= 0))
+    {
+        _busy = false;
+    }
+    return _busy || converting(u32Now);
+}
+
+bool SHT31Model::converting(uint32_t u32Now)
+{
+    return (_mode == MODEL_SINGLE) && ((u32Now - _start) < _duration);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool write(const uint8_t *data, uint8_t len).
+ * ----------------------------------------------------------------------------
+*/
+bool SHT31Model::write(const uint8_t *data, uint8_t len)
+{
+    uint32_t u32Now = (uint32_t) micros();
+    if (nackNext != 0)
+    {
+        nackNext--;
+        return false;
+    }
+    if (nackWrites != 0)
+    {
+        nackWrites--;
+        return false;
+    }
+    if (converting(u32Now) || (isBusy(u32Now) && (len != 0)))
+    {
+        busyNacks++;
+        return false;
+    }
+    if (len < 2)
+    {
+        return true;    /* Address probe */
+    }
+    execute((uint16_t) ((data[0] << 8) | data[1]), u32Now);
+    return true;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function void execute(uint16_t command, uint32_t u32Now).
+ * @details In periodic and ART mode only fetch, break, reset, heater and
+ * status commands are processed.
+ * ----------------------------------------------------------------------------
+*/
+void SHT31Model::execute(uint16_t command, uint32_t u32Now)
+{
+    static const uint16_t SINGLE[6] = { 0x2C06, 0x2C0D, 0x2C10, 0x2400, 0x240B, 0x2416 };
+    static const uint8_t PERIODIC[5][4] =
+    {
+        { 0x20, 0x32, 0x24, 0x2F },
+        { 0x21, 0x30, 0x26, 0x2D },
+        { 0x22, 0x36, 0x20, 0x2B },
+        { 0x23, 0x34, 0x22, 0x29 },
+        { 0x27, 0x37, 0x21, 0x2A }
+    };
+    static const uint32_t PERIOD_US[5] = { 2000000, 1000000, 500000, 250000, 100000 };
+
+    lastCommand = command;
+    _pending = PENDING_NONE;
+    bool periodic = (_mode == MODEL_PERIODIC) || (_mode == MODEL_ART);
+
+    switch (command)
+    {
+        case 0xE000:    /* Fetch */
+            if (periodic == false)
+            {
+                status |= MODEL_STATUS_CMD;
+                return;
+            }
+            _pending = PENDING_FETCH;
+            break;
+        case 0x3093:    /* Break */
+            _mode      = MODEL_IDLE;
+            _busy      = true;
+            _busyUntil = u32Now + BREAK_US;
+            break;
+        case 0x30A2:    /* Soft reset */
+            _mode      = MODEL_IDLE;
+            status     = MODEL_STATUS_RESET;
+            _busy      = true;
+            _busyUntil = u32Now + SOFT_RESET_US;
+            resets++;
+            break;
+        case 0x306D:    /* Heater on */
+            status |= MODEL_STATUS_HEATER;
+            break;
+        case 0x3066:    /* Heater off */
+            status &= ~MODEL_STATUS_HEATER;
+            break;
+        case 0xF32D:    /* Read status */
+            _pending = PENDING_STATUS;
+            break;
+        case 0x3041:    /* Clear status */
+            status &= ~(0x8000 | 0x0800 | 0x0400 | 0x0010);
+            break;
+        case 0x2B32:    /* ART */
+            if (periodic)
+            {
+                status |= MODEL_STATUS_CMD;
+                return;
+            }
+            _mode     = MODEL_ART;
+            _start    = u32Now;
+            _duration = conversionUs[0];
+            _period   = 250000;
+            _fetched  = 0;
+            break;
+        default:
+        {
+            bool known = false;
+            for (uint8_t i = 0; (i < 6) && (periodic == false); i++)
+            {
+                if (command == SINGLE[i])
+                {
+                    _mode       = MODEL_SINGLE;
+                    _start      = u32Now;
+                    _duration   = conversionUs[i % 3];
+                    _stretching = (i < 3);
+                    _pending    = PENDING_DATA;
+                    conversions++;
+                    known = true;
+                }
+            }
+            for (uint8_t r = 0; (r < 5) && (periodic == false) && (known == false); r++)
+            {
+                for (uint8_t i = 1; i < 4; i++)
+                {
+                    if (command == ((PERIODIC[r][0] << 8) | PERIODIC[r][i]))
+                    {
+                        _mode     = MODEL_PERIODIC;
+                        _start    = u32Now;
+                        _duration = conversionUs[i - 1];
+                        _period   = PERIOD_US[r];
+                        _fetched  = 0;
+                        known = true;
+                    }
+                }
+            }
+            if (known == false)
+            {
+                status |= MODEL_STATUS_CMD;
+                return;
+            }
+            break;
+        }
+    }
+    status &= ~MODEL_STATUS_CMD;
+    commands++;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint32_t stretch().
+ * @details Single shot with clock stretching holds SCL until done.
+ * ----------------------------------------------------------------------------
+*/
+uint32_t SHT31Model::stretch()
+{
+    uint32_t u32Now = (uint32_t) micros();
+    if ((_pending == PENDING_DATA) && _stretching && converting(u32Now))
+    {
+        return _duration - (u32Now - _start);
+    }
+    return 0;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function bool read(uint8_t *data, uint8_t len).
+ * ----------------------------------------------------------------------------
+*/
+bool SHT31Model::read(uint8_t *data, uint8_t len)
+{
+    uint32_t u32Now = (uint32_t) micros();
+    if (nackNext != 0)
+    {
+        nackNext--;
+        return false;
+    }
+    if (isBusy(u32Now))
+    {
+        busyNacks++;
+        return false;
+    }
+
+    switch (_pending)
+    {
+        case PENDING_DATA:
+            _mode    = MODEL_IDLE;
+            _pending = PENDING_NONE;
+            fill(data, len, rawT, rawH, 2);
+            dataReads++;
+            return true;
+        case PENDING_FETCH:
+        {
+            _pending = PENDING_NONE;
+            uint32_t u32Elapsed = u32Now - _start;
+            if (u32Elapsed < _duration)
+            {
+                return false;
+            }
+            uint32_t u32Samples = 1 + (u32Elapsed - _duration) / _period;
+            if (u32Samples <= _fetched)
+            {
+                return false;
+            }
+            _fetched = u32Samples;
+            fill(data, len, rawT, rawH, 2);
+            dataReads++;
+            return true;
+        }
+        case PENDING_STATUS:
+            _pending = PENDING_NONE;
+            fill(data, len, status, 0, 1);
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* Words with CRC, bytes after them read as 0xFF */
+void SHT31Model::fill(uint8_t *data, uint8_t len, uint16_t first, uint16_t second, uint8_t words)
+{
+    uint8_t frame[6];
+    frame[0] = (uint8_t) (first >> 8);
+    frame[1] = (uint8_t) first;
+    frame[2] = crc8(&frame[0], 2);
+    frame[3] = (uint8_t) (second >> 8);
+    frame[4] = (uint8_t) second;
+    frame[5] = crc8(&frame[3], 2);
+    if (corruptCrc != 0)
+    {
+        corruptCrc--;
+        frame[(words == 2) ? 5 : 2] ^= 0x01;
+    }
+    for (uint8_t i = 0; i < len; i++)
+    {
+        data[i] = (i < words * 3) ? frame[i] : 0xFF;
+    }
+}
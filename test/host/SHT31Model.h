@@ -0,0 +1,91 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file SHT31Model.h
+ * @brief Simulated SHT31 for TD_SHT31 tests.
+ * @details Decodes the command set - refer datasheet pages 10-14:
+ * - Single shot with (read is stretched) and without clock stretching
+ *   (read is NACKed while converting).
+ * - Periodic and ART mode, fetch NACKs if there is no new sample.
+ * - Break, soft reset, heater, status read and clear.
+ * - Write and read are NACKed while converting. During reset and break
+ *   address probe is ACKed, commands and reads are NACKed.
+ * - Unknown command is ACKed and sets status bit 1.
+ * Time is taken from micros(), so the model runs on host virtual clock and
+ * in real time with Linux backend.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef SHT31_MODEL_H
+#define SHT31_MODEL_H
+
+#include "HostDevice.h"
+
+#define MODEL_IDLE          0
+#define MODEL_SINGLE        1
+#define MODEL_PERIODIC      2
+#define MODEL_ART           3
+
+#define MODEL_STATUS_RESET  0x8010      /* Alert pending, reset detected */
+#define MODEL_STATUS_HEATER 0x2000
+#define MODEL_STATUS_CMD    0x0002      /* Last command not processed */
+
+/**
+ * @class SHT31Model.
+ * @brief Simulated SHT31.
+*/
+class SHT31Model : public HostDevice
+{
+    public:
+    SHT31Model(uint8_t address = 0x44);
+
+    virtual bool write(const uint8_t *data, uint8_t len);
+    virtual uint32_t stretch();
+    virtual bool read(uint8_t *data, uint8_t len);
+
+    /**
+     * @brief Set measured value as raw ticks or physical values.
+    */
+    void setRaw(uint16_t u16T, uint16_t u16H);
+    void set(float celsius, float humidity);
+
+    /**
+     * @brief Datasheet CRC-8, bitwise reference.
+    */
+    static uint8_t crc8(const uint8_t *data, uint8_t len);
+
+    uint8_t mode() const { return _mode; }
+
+    /* Stimulus */
+    uint32_t conversionUs[3];           /* By repeatability high/medium/low */
+    uint8_t corruptCrc;                 /* Following data reads with bad CRC */
+    uint8_t nackNext;                   /* Following transfers NACKed */
+    uint8_t nackWrites;                 /* Following writes NACKed, reads pass */
+
+    /* Observation */
+    uint16_t status;
+    uint16_t rawT;
+    uint16_t rawH;
+    uint16_t lastCommand;
+    uint32_t commands;                  /* Processed commands */
+    uint32_t conversions;               /* Single shots started */
+    uint32_t busyNacks;                 /* Transfers NACKed while busy */
+    uint32_t dataReads;                 /* Measurement data read */
+    uint32_t resets;                    /* Soft resets processed */
+
+    private:
+    uint8_t _mode;
+    uint8_t _pending;                   /* Read expected after command */
+    bool _stretching;
+    uint32_t _start;                    /* Conversion or mode start */
+    uint32_t _duration;                 /* Conversion time */
+    uint32_t _period;                   /* Periodic interval */
+    uint32_t _fetched;                  /* Periodic samples fetched */
+    uint32_t _busyUntil;                /* Reset or break */
+    bool _busy;
+
+    bool isBusy(uint32_t u32Now);
+    bool converting(uint32_t u32Now);
+    void execute(uint16_t command, uint32_t u32Now);
+    void fill(uint8_t *data, uint8_t len, uint16_t first, uint16_t second, uint8_t words);
+};
+
+#endif  //SHT31_MODEL_H
@@ -0,0 +1,108 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file Wire.h
+ * @brief Host stand-in of TwoWire for TD_SHT31 tests.
+ * @details Simulated bus with attached HostDevice models and optional
+ * TCA9548A style multiplexer. Transfers advance the virtual clock by bus
+ * time, are counted and logged. Two devices answering the same address at
+ * once are counted as collision.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include "Arduino.h"
+#include "HostDevice.h"
+
+#define WIRE_HAS_TIMEOUT    1
+
+#define HOST_WIRE_BUFFER    32
+#define HOST_MAX_DEVICES    32
+#define HOST_LOG_SIZE       256
+#define HOST_ROOT           0xFF    /* Device not behind multiplexer */
+
+/**
+ * @brief Transfer log entry.
+*/
+struct HostTransfer
+{
+    uint8_t address;
+    bool read;
+    bool ack;
+    bool repeatedStart;                 /* Read followed held write */
+    uint8_t len;
+    uint8_t data[2];                    /* First written bytes */
+};
+
+/**
+ * @class TwoWire.
+ * @brief TwoWire stand-in.
+*/
+class TwoWire
+{
+    public:
+    TwoWire();
+
+    void begin() { _begun++; }
+    void end() {}
+    void setClock(uint32_t u32Clock) { _clock = u32Clock; }
+    void setWireTimeout(uint32_t u32Timeout, bool reset) { _timeout = u32Timeout; (void) reset; }
+    bool getWireTimeoutFlag() { return _timeoutFlag; }
+    void clearWireTimeoutFlag() { _timeoutFlag = false; }
+
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t len);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t len);
+    int available();
+    int read();
+
+    /**
+     * @brief Simulation control.
+    */
+    void attach(HostDevice *device, uint8_t channel = HOST_ROOT);
+    void attachMux(uint8_t address = 0x70);
+    void detachAll();
+    uint8_t muxMask() { return _muxMask; }
+    void clearLog();
+
+    uint32_t clock() { return _clock; }
+    uint32_t begun() { return _begun; }
+
+    uint32_t transfers;                 /* Address headers sent */
+    uint32_t bytes;                     /* Address and data bytes clocked */
+    uint32_t collisions;
+    uint32_t repeatedStarts;
+    uint32_t logCount;                  /* May exceed HOST_LOG_SIZE */
+    HostTransfer log[HOST_LOG_SIZE];
+
+    private:
+    HostDevice *_devices[HOST_MAX_DEVICES];
+    uint8_t _channels[HOST_MAX_DEVICES];
+    uint8_t _count;
+    bool _mux;
+    uint8_t _muxAddress;
+    uint8_t _muxMask;
+    uint32_t _clock;
+    uint32_t _timeout;
+    bool _timeoutFlag;
+    uint32_t _begun;
+    uint8_t _address;
+    uint8_t _txBuffer[HOST_WIRE_BUFFER];
+    uint8_t _txLength;
+    bool _txHeld;
+    uint8_t _rxBuffer[HOST_WIRE_BUFFER];
+    uint8_t _rxLength;
+    uint8_t _rxIndex;
+
+    HostDevice *find(uint8_t address);
+    void busTime(uint32_t count);
+    void countBytes(uint32_t count);
+    void record(uint8_t address, bool read, bool ack, uint8_t len, const uint8_t *data);
+    bool writeTo(uint8_t address, const uint8_t *data, uint8_t len);
+};
+
+extern TwoWire Wire;
+
+#endif  //HOST_WIRE_H
@@ -0,0 +1,63 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file check.h
+ * @brief Minimal test assertions for TD_SHT31 tests.
+ * ----------------------------------------------------------------------------
+*/
+#ifndef HOST_CHECK_H
+#define HOST_CHECK_H
+
+#include <stdio.h>
+
+static unsigned checkCount   = 0;
+static unsigned checkFailures = 0;
+
+#define CHECK(cond) \
+    do \
+    { \
+        checkCount++; \
+        if (!(cond)) \
+        { \
+            checkFailures++; \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) \
+    do \
+    { \
+        checkCount++; \
+        long long _a = (long long) (a); \
+        long long _b = (long long) (b); \
+        if (_a != _b) \
+        { \
+            checkFailures++; \
+            printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", \
+                   __FILE__, __LINE__, #a, #b, _a, _b); \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tolerance) \
+    do \
+    { \
+        checkCount++; \
+        double _a = (double) (a); \
+        double _b = (double) (b); \
+        if ((_a - _b > (tolerance)) || (_b - _a > (tolerance))) \
+        { \
+            checkFailures++; \
+            printf("%s:%d: CHECK_NEAR(%s, %s) failed: %g != %g\n", \
+                   __FILE__, __LINE__, #a, #b, _a, _b); \
+        } \
+    } while (0)
+
+/**
+ * @brief Print result, return process exit code.
+*/
+static inline int checkSummary(const char *name)
+{
+    printf("%s: %u checks, %u failed\n", name, checkCount, checkFailures);
+    return (checkFailures == 0) ? 0 : 1;
+}
+
+#endif  //HOST_CHECK_H
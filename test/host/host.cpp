@@ -0,0 +1,318 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file host.cpp
+ * @brief Host stand-in of Arduino core and TwoWire for TD_SHT31 tests.
+ * ----------------------------------------------------------------------------
+*/
+#include "Arduino.h"
+#include "Wire.h"
+
+TwoWire Wire;
+HardwareSerial Serial;
+
+uint32_t hostDelayCalls  = 0;
+uint64_t hostDelayMicros = 0;
+void (*hostYieldHook)()  = NULL;
+uint32_t hostYieldCalls  = 0;
+void (*hostPinHook)(uint8_t pin) = NULL;
+
+static uint64_t hostNow = 0;
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Virtual clock.
+ * ----------------------------------------------------------------------------
+*/
+uint64_t hostTime()
+{
+    return hostNow;
+}
+
+void hostSetTime(uint64_t u64Time)
+{
+    hostNow = u64Time;
+}
+
+void hostAdvance(uint32_t u32Micros)
+{
+    hostNow += u32Micros;
+}
+
+unsigned long millis()
+{
+    hostNow += HOST_CALL_US;
+    return (unsigned long) (uint32_t) (hostNow / 1000);
+}
+
+unsigned long micros()
+{
+    hostNow += HOST_CALL_US;
+    return (unsigned long) (uint32_t) hostNow;
+}
+
+void delay(unsigned long ms)
+{
+    hostDelayCalls++;
+    hostDelayMicros += (uint64_t) ms * 1000;
+    hostNow += (uint64_t) ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    hostDelayCalls++;
+    hostDelayMicros += us;
+    hostNow += us;
+}
+
+void yield()
+{
+    hostYieldCalls++;
+    hostNow += HOST_CALL_US;
+    if (hostYieldHook != NULL)
+    {
+        hostYieldHook();
+    }
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief TwoWire stand-in.
+ * ----------------------------------------------------------------------------
+*/
+TwoWire::TwoWire()
+{
+    _count   = 0;
+    _clock   = 100000;
+    _timeout = 25000;
+    _begun   = 0;
+    detachAll();
+}
+
+void TwoWire::attach(HostDevice *device, uint8_t channel)
+{
+    if (_count < HOST_MAX_DEVICES)
+    {
+        _devices[_count]  = device;
+        _channels[_count] = channel;
+        _count++;
+    }
+}
+
+void TwoWire::attachMux(uint8_t address)
+{
+    _mux        = true;
+    _muxAddress = address;
+    _muxMask    = 0;
+}
+
+void TwoWire::detachAll()
+{
+    _count       = 0;
+    _mux         = false;
+    _muxMask     = 0;
+    _timeoutFlag = false;
+    _txLength    = 0;
+    _txHeld      = false;
+    _rxLength    = 0;
+    _rxIndex     = 0;
+    clearLog();
+}
+
+void TwoWire::clearLog()
+{
+    transfers      = 0;
+    bytes          = 0;
+    collisions     = 0;
+    repeatedStarts = 0;
+    logCount       = 0;
+}
+
+/* Visible device at address, multiplexer channel must be selected */
+HostDevice *TwoWire::find(uint8_t address)
+{
+    HostDevice *found = NULL;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (_devices[i]->address != address)
+        {
+            continue;
+        }
+        if ((_channels[i] != HOST_ROOT) && ((_muxMask & (1 << _channels[i])) == 0))
+        {
+            continue;
+        }
+        if (found != NULL)
+        {
+            collisions++;
+            continue;
+        }
+        found = _devices[i];
+    }
+    return found;
+}
+
+/* Bytes with ACK bit, START or STOP bit per transfer start */
+void TwoWire::busTime(uint32_t count)
+{
+    hostNow += ((uint64_t) (count * 9 + 1) * 1000000 + _clock - 1) / _clock;
+}
+
+void TwoWire::countBytes(uint32_t count)
+{
+    transfers++;
+    bytes += count;
+}
+
+void TwoWire::record(uint8_t address, bool read, bool ack, uint8_t len, const uint8_t *data)
+{
+    if (logCount < HOST_LOG_SIZE)
+    {
+        HostTransfer *entry = &log[logCount];
+        entry->address       = address;
+        entry->read          = read;
+        entry->ack           = ack;
+        entry->repeatedStart = read && _txHeld && (_address == address);
+        entry->len           = len;
+        entry->data[0]       = ((data != NULL) && (len > 0)) ? data[0] : 0;
+        entry->data[1]       = ((data != NULL) && (len > 1)) ? data[1] : 0;
+    }
+    logCount++;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    _address  = address;
+    _txLength = 0;
+    _txHeld   = false;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+    if (_txLength >= HOST_WIRE_BUFFER)
+    {
+        return 0;
+    }
+    _txBuffer[_txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t len)
+{
+    size_t count = 0;
+    while ((count < len) && (write(data[count]) == 1))
+    {
+        count++;
+    }
+    return count;
+}
+
+bool TwoWire::writeTo(uint8_t address, const uint8_t *data, uint8_t len)
+{
+    if (_mux && (address == _muxAddress))
+    {
+        if (len >= 1)
+        {
+            _muxMask = data[len - 1];
+        }
+        return true;
+    }
+    HostDevice *device = find(address);
+    return (device != NULL) && device->write(data, len);
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t endTransmission(bool sendStop).
+ * @details Write is executed at once. Without STOP next requestFrom to
+ * same address is repeated start.
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+    busTime((uint32_t) _txLength + 1);
+    bool ack = writeTo(_address, _txBuffer, _txLength);
+    countBytes(ack ? (uint32_t) _txLength + 1 : 1);
+    _txHeld = false;
+    record(_address, false, ack, _txLength, _txBuffer);
+    _txHeld = ack && (sendStop == false);
+    _txLength = 0;
+    return ack ? 0 : 2;
+}
+
+/**
+ * ----------------------------------------------------------------------------
+ * @brief Function uint8_t requestFrom(uint8_t address, uint8_t len).
+ * @details Device sees read after address byte, clock stretching delays
+ * data bytes.
+ * ----------------------------------------------------------------------------
+*/
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t len)
+{
+    _rxLength = 0;
+    _rxIndex  = 0;
+    if (len > HOST_WIRE_BUFFER)
+    {
+        len = HOST_WIRE_BUFFER;
+    }
+    if (_txHeld && (_address == address))
+    {
+        repeatedStarts++;
+    }
+
+    busTime(1);
+    bool ack;
+    if (_mux && (address == _muxAddress))
+    {
+        memset(_rxBuffer, _muxMask, len);
+        ack = true;
+    } else
+    {
+        HostDevice *device = find(address);
+        ack = (device != NULL);
+        if (ack)
+        {
+            uint32_t u32Stretch = device->stretch();
+            if ((_timeout != 0) && (u32Stretch > _timeout))
+            {
+                hostNow += _timeout;
+                _timeoutFlag = true;
+                countBytes(1);
+                record(address, true, false, len, NULL);
+                _txHeld = false;
+                return 0;
+            }
+            hostNow += u32Stretch;
+            ack = device->read(_rxBuffer, len);
+        }
+    }
+    if (ack)
+    {
+        busTime(len);
+        countBytes((uint32_t) len + 1);
+    } else
+    {
+        countBytes(1);
+    }
+    record(address, true, ack, len, NULL);
+    _txHeld = false;
+    if (ack == false)
+    {
+        return 0;
+    }
+    _rxLength = len;
+    return len;
+}
+
+int TwoWire::available()
+{
+    return _rxLength - _rxIndex;
+}
+
+int TwoWire::read()
+{
+    if (_rxIndex >= _rxLength)
+    {
+        return -1;
+    }
+    return _rxBuffer[_rxIndex++];
+}
@@ -0,0 +1,19 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file layout.cpp
+ * @brief Size of TD_SHT31, built once per TD_SHT31_ERROR_POLICY and linked
+ * into every test_errors build.
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31.h"
+
+#if TD_SHT31_ERROR_POLICY == ERRORS_FULL
+size_t layoutSizeFull()
+#elif TD_SHT31_ERROR_POLICY == ERRORS_LEAN
+size_t layoutSizeLean()
+#else
+size_t layoutSizeNone()
+#endif
+{
+    return sizeof(TD_SHT31);
+}
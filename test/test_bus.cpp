@@ -0,0 +1,79 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file test_bus.cpp
+ * @brief TD_SHT31Bus with 16 sensors behind multiplexer and direct sensor.
+ * @details Built with -DSHT31_BUS_MAX_SENSORS=24. Every multiplexer
+ * channel has sensors at 0x44 and 0x45. Last channel also has other
+ * device at 0x46, address of direct sensor, so channel left selected
+ * causes address collision.
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31.h"
+#include "TD_SHT31Bus.h"
+#include "SHT31Model.h"
+#include "check.h"
+
+#define CHANNELS            8
+#define MUX_SENSORS         (2 * CHANNELS)
+#define SENSORS             (MUX_SENSORS + 1)
+#define DIRECT_ADDRESS      0x46
+
+static bool selectChannel(uint8_t channel)
+{
+    Wire.beginTransmission(0x70);
+    Wire.write((channel == NO_MUX_CHANNEL) ? 0 : (1 << channel));
+    return (Wire.endTransmission() == 0);
+}
+
+int main()
+{
+    static SHT31Model models[SENSORS];
+    static TD_SHT31 *sensors[SENSORS];
+    SHT31Model other(DIRECT_ADDRESS);
+    TD_SHT31Bus bus;
+    Wire.attachMux(0x70);
+    Wire.attach(&other, CHANNELS - 1);
+    bus.setMuxSelect(selectChannel);
+
+    /* Direct sensor first, bus sorts it after multiplexer channels */
+    for (uint8_t i = 0; i < SENSORS; i++)
+    {
+        uint8_t address = (i == 0) ? DIRECT_ADDRESS : ((i & 1) ? 0x44 : 0x45);
+        uint8_t channel = (i == 0) ? NO_MUX_CHANNEL : (uint8_t) ((i - 1) / 2);
+        models[i] = SHT31Model(address);
+        models[i].set(10.0f + i, 20.0f + i);
+        Wire.attach(&models[i], (channel == NO_MUX_CHANNEL) ? HOST_ROOT : channel);
+        sensors[i] = new TD_SHT31(address);
+        CHECK(selectChannel(channel));
+        CHECK(sensors[i]->begin(&Wire));
+        CHECK(bus.addSensor(sensors[i], channel));
+    }
+    CHECK_EQ(bus.getSensorCount(), SENSORS);
+    CHECK_EQ(Wire.collisions, 0);
+
+    /* Direct sensor is read after channels are deselected */
+    bus.getBusBytes();
+    Wire.bytes = 0;
+    for (uint8_t sweep = 0; sweep < 3; sweep++)
+    {
+        CHECK(bus.runAll(CMD_SS_CSD_HIGH));
+        for (uint8_t i = 0; i < SENSORS; i++)
+        {
+            int16_t iT;
+            int16_t iH;
+            CHECK(bus.getResult(i, &iT, &iH));
+            CHECK_NEAR(iT, 1000 + 100 * i, 1);
+            CHECK_NEAR(iH, 2000 + 100 * i, 1);
+        }
+    }
+    CHECK_EQ(Wire.collisions, 0);
+    CHECK_EQ(Wire.muxMask(), 0);
+    CHECK_EQ(other.commands, 0);
+    CHECK_EQ(bus.getBusBytes(), Wire.bytes);
+
+    for (uint8_t i = 0; i < SENSORS; i++)
+    {
+        delete sensors[i];
+    }
+    return checkSummary("test_bus");
+}
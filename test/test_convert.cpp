@@ -0,0 +1,52 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file test_convert.cpp
+ * @brief Raw tick converters against datasheet formulas (double precision)
+ * for all 65536 codes.
+ * @details Multiply-shift divides by 65536 instead of 65535, integer
+ * result must stay within 1 LSB (0.01 units) of exact value.
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31.h"
+#include "check.h"
+
+#include <math.h>
+
+int main()
+{
+    double cError = 0, fError = 0, hError = 0;
+    double cFloat = 0, fFloat = 0, hFloat = 0;
+    for (uint32_t code = 0; code <= 0xFFFF; code++)
+    {
+        uint16_t u16 = (uint16_t) code;
+        double c = 100.0 * (-45.0 + 175.0 * code / 65535.0);
+        double f = 100.0 * (-49.0 + 315.0 * code / 65535.0);
+        double h = 100.0 * (100.0 * code / 65535.0);
+
+        cError = fmax(cError, fabs(TD_SHT31::ticksToCentiCelsius(u16) - c));
+        fError = fmax(fError, fabs(TD_SHT31::ticksToCentiFarenheit(u16) - f));
+        hError = fmax(hError, fabs(TD_SHT31::ticksToCentiHumidity(u16) - h));
+
+        cFloat = fmax(cFloat, fabs(100.0 * TD_SHT31::ticksToCelsius(u16) - c));
+        fFloat = fmax(fFloat, fabs(100.0 * TD_SHT31::ticksToFarenheit(u16) - f));
+        hFloat = fmax(hFloat, fabs(100.0 * TD_SHT31::ticksToHumidity(u16) - h));
+    }
+    printf("test_convert: worst error %.2f C, %.2f F, %.2f %%RH LSB\n",
+           cError, fError, hError);
+    CHECK(cError <= 1.0);
+    CHECK(fError <= 1.0);
+    CHECK(hError <= 1.0);
+    CHECK(cFloat <= 0.01);
+    CHECK(fFloat <= 0.01);
+    CHECK(hFloat <= 0.01);
+
+    /* End points */
+    CHECK_EQ(TD_SHT31::ticksToCentiCelsius(0), -4500);
+    CHECK_EQ(TD_SHT31::ticksToCentiCelsius(0xFFFF), 13000);
+    CHECK_EQ(TD_SHT31::ticksToCentiFarenheit(0), -4900);
+    CHECK_EQ(TD_SHT31::ticksToCentiFarenheit(0xFFFF), 26600);
+    CHECK_EQ(TD_SHT31::ticksToCentiHumidity(0), 0);
+    CHECK_EQ(TD_SHT31::ticksToCentiHumidity(0xFFFF), 10000);
+
+    return checkSummary("test_convert");
+}
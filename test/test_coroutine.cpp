@@ -0,0 +1,82 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file test_coroutine.cpp
+ * @brief TD_SHT31Executor with simulated sensors (-std=c++20).
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31.h"
+#include "TD_SHT31Coroutine.h"
+#include "SHT31Model.h"
+#include "check.h"
+
+#define ROUNDS      10
+#define PERIOD_US   100000UL
+
+static uint16_t good[3];
+static uint16_t bad[3];
+static uint16_t lastStatus[3];
+
+static TD_SHT31Task readSensor(TD_SHT31Executor *ex, TD_SHT31 *sht, uint8_t index)
+{
+    for (uint8_t i = 0; i < ROUNDS; i++)
+    {
+        TD_SHT31Measurement m = co_await ex->measure(sht, CMD_SS_CSD_HIGH);
+        if (m.ok())
+        {
+            good[index]++;
+        } else
+        {
+            bad[index]++;
+        }
+        lastStatus[index] = m.status;
+        co_await ex->sleep(PERIOD_US);
+    }
+}
+
+int main()
+{
+    SHT31Model model1(0x44);
+    SHT31Model model2(0x45);
+    Wire.attach(&model1);
+    Wire.attach(&model2);
+    TD_SHT31 sht1(0x44);
+    TD_SHT31 sht2(0x45);
+    TD_SHT31 missing(0x46);
+    CHECK(sht1.begin(&Wire));
+    CHECK(sht2.begin(&Wire));
+    missing.begin(&Wire);
+    missing.getLastError();
+    CHECK(missing.startSingleShot(CMD_PER_1_HIGH) == false);
+
+    TD_SHT31Executor executor;
+    executor.spawn(readSensor(&executor, &sht1, 0));
+    executor.spawn(readSensor(&executor, &sht2, 1));
+    executor.spawn(readSensor(&executor, &missing, 2));
+    CHECK_EQ(executor.tasks(), 3);
+
+    hostYieldCalls  = 0;
+    hostDelayMicros = 0;
+    uint64_t u64Start = hostTime();
+    executor.run();
+    uint64_t u64Elapsed = hostTime() - u64Start;
+
+    CHECK_EQ(executor.tasks(), 0);
+    CHECK_EQ(good[0], ROUNDS);
+    CHECK_EQ(good[1], ROUNDS);
+    CHECK_EQ(bad[2], ROUNDS);
+
+    /* Conversions overlap: one sensor's time (datasheet maximum), not sum */
+    uint64_t u64Round = PERIOD_US + 16000;
+    CHECK(u64Elapsed >= ROUNDS * PERIOD_US);
+    CHECK(u64Elapsed < ROUNDS * (u64Round + 2000));
+
+    /* Executor sleeps instead of spinning */
+    CHECK(hostDelayMicros > u64Elapsed * 9 / 10);
+    CHECK(hostYieldCalls < 10);
+
+    /* Failed start reports only its own error, sticky error is kept */
+    CHECK_EQ(lastStatus[2], ERROR_END_TRANSMISSION);
+    CHECK_EQ(missing.getLastError(), ERROR_WRONG_COMMAND | ERROR_END_TRANSMISSION);
+
+    return checkSummary("test_coroutine");
+}
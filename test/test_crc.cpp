@@ -0,0 +1,48 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file test_crc.cpp
+ * @brief TD_SHT31::crc8 against bitwise reference, built once per
+ * TD_SHT31_CRC_METHOD.
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31.h"
+#include "SHT31Model.h"
+#include "check.h"
+
+int main()
+{
+    /* Datasheet example - refer datasheet page 14 */
+    const uint8_t EXAMPLE[2] = { 0xBE, 0xEF };
+    CHECK_EQ(TD_SHT31::crc8(EXAMPLE, 2), 0x92);
+
+    uint32_t u32Mismatch = 0;
+    for (uint32_t i = 0; i <= 0xFFFF; i++)
+    {
+        uint8_t data[2] = { (uint8_t) (i >> 8), (uint8_t) i };
+        if (TD_SHT31::crc8(data, 2) != SHT31Model::crc8(data, 2))
+        {
+            u32Mismatch++;
+        }
+    }
+    CHECK_EQ(u32Mismatch, 0);
+
+    uint8_t data[6] = { 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC };
+    for (uint8_t len = 0; len <= 6; len++)
+    {
+        CHECK_EQ(TD_SHT31::crc8(data, len), SHT31Model::crc8(data, len));
+    }
+
+    /* Decode path with the compiled method */
+    SHT31Model model(0x44);
+    Wire.attach(&model);
+    TD_SHT31 sht(0x44);
+    CHECK(sht.begin(&Wire));
+    TD_SHT31Measurement m = sht.measure(CMD_SS_CSD_HIGH);
+    CHECK(m.ok());
+    CHECK_NEAR(m.temperature, 2345, 1);
+    model.corruptCrc = 1;
+    CHECK_EQ(sht.measure(CMD_SS_CSD_HIGH).status, ERROR_CRC_CHECK);
+
+    static const char *METHODS[3] = { "test_crc_bitwise", "test_crc_nibble", "test_crc_table" };
+    return checkSummary(METHODS[TD_SHT31_CRC_METHOD]);
+}
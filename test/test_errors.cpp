@@ -0,0 +1,71 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file test_errors.cpp
+ * @brief Error accounting, built once per TD_SHT31_ERROR_POLICY.
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31.h"
+#include "SHT31Model.h"
+#include "check.h"
+
+size_t layoutSizeFull();
+size_t layoutSizeLean();
+size_t layoutSizeNone();
+
+int main()
+{
+    SHT31Model model(0x44);
+    Wire.attach(&model);
+    TD_SHT31 sht(0x44);
+    TD_SHT31 missing(0x45);
+    CHECK(sht.begin(&Wire));
+    missing.begin(&Wire);
+    missing.getLastError();
+
+    /* Two failing calls */
+    CHECK(missing.startSingleShot(CMD_PER_1_HIGH) == false);
+    CHECK(missing.isSensorConnected() == false);
+    int error = missing.getLastError();
+    CHECK_EQ(missing.getLastError(), NO_ERROR);
+
+    /* Failing and succeeding measurement */
+    TD_SHT31Measurement bad  = missing.measure(CMD_SS_CSD_HIGH);
+    TD_SHT31Measurement good = sht.measure(CMD_SS_CSD_HIGH);
+    CHECK(bad.ok() == false);
+    CHECK(good.ok());
+    CHECK_NEAR(good.temperature, 2345, 1);
+
+    /* Failing call followed by succeeding call */
+    CHECK(sht.startSingleShot(CMD_PER_1_HIGH) == false);
+    CHECK(sht.isSensorConnected());
+    int latest = sht.getLastError();
+
+    /* NONE drops int _error_code, LEAN keeps uint16_t status */
+    CHECK(layoutSizeNone() < layoutSizeFull());
+    CHECK(layoutSizeNone() <= layoutSizeLean());
+    CHECK(layoutSizeLean() <= layoutSizeFull());
+    CHECK(layoutSizeFull() - layoutSizeNone() >= sizeof(int));
+
+    #if TD_SHT31_ERROR_POLICY == ERRORS_FULL
+    CHECK_EQ(sizeof(TD_SHT31), layoutSizeFull());
+    CHECK_EQ(error, ERROR_WRONG_COMMAND | ERROR_END_TRANSMISSION);
+    CHECK_EQ(bad.status, ERROR_END_TRANSMISSION);
+    CHECK_EQ(missing.getLastError(), ERROR_END_TRANSMISSION);
+    CHECK_EQ(latest, ERROR_WRONG_COMMAND);
+    return checkSummary("test_errors_full");
+    #elif TD_SHT31_ERROR_POLICY == ERRORS_LEAN
+    CHECK_EQ(sizeof(TD_SHT31), layoutSizeLean());
+    CHECK_EQ(error, ERROR_END_TRANSMISSION);
+    CHECK_EQ(bad.status, ERROR_END_TRANSMISSION);
+    CHECK_EQ(missing.getLastError(), ERROR_END_TRANSMISSION);
+    CHECK_EQ(latest, NO_ERROR);
+    return checkSummary("test_errors_lean");
+    #else
+    CHECK_EQ(sizeof(TD_SHT31), layoutSizeNone());
+    CHECK_EQ(error, NO_ERROR);
+    CHECK_EQ(bad.status, ERROR_UNKNOWN);
+    CHECK_EQ(missing.getLastError(), NO_ERROR);
+    CHECK_EQ(latest, NO_ERROR);
+    return checkSummary("test_errors_none");
+    #endif
+}
@@ -0,0 +1,96 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file test_linux.cpp
+ * @brief Linux i2c-dev backend with simulated sensor behind transfer hook.
+ * @details Built with TD_SHT31_LINUX, runs in real time. Hook plays the
+ * kernel I2C_RDWR ioctl against SHT31Model.
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31.h"
+#include "host/SHT31Model.h"
+#include "host/check.h"
+
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+static SHT31Model model(0x44);
+static uint32_t messages[2];            /* Last ioctl: write, read */
+static uint32_t combined;               /* Ioctls with write and read */
+
+static int transfer(struct i2c_rdwr_ioctl_data *data)
+{
+    messages[0] = 0;
+    messages[1] = 0;
+    for (uint32_t i = 0; i < data->nmsgs; i++)
+    {
+        struct i2c_msg *msg = &data->msgs[i];
+        if (msg->addr != model.address)
+        {
+            return -1;
+        }
+        bool ack;
+        if (msg->flags & I2C_M_RD)
+        {
+            messages[1]++;
+            delayMicroseconds(model.stretch());
+            ack = model.read(msg->buf, (uint8_t) msg->len);
+        } else
+        {
+            messages[0]++;
+            ack = model.write(msg->buf, (uint8_t) msg->len);
+        }
+        if (ack == false)
+        {
+            return -1;
+        }
+    }
+    if (data->nmsgs == 2)
+    {
+        combined++;
+    }
+    return data->nmsgs;
+}
+
+int main()
+{
+    Wire.setTransferHook(transfer);
+    TD_SHT31 sht(0x44);
+    CHECK(sht.begin());
+    Wire.getTransferCount();
+
+    /* Status command and read in one ioctl */
+    combined = 0;
+    CHECK(sht.readSensorStatus() != 0xFFFF);
+    CHECK_EQ(Wire.getTransferCount(), 1);
+    CHECK_EQ(combined, 1);
+    CHECK_EQ(messages[0], 1);
+    CHECK_EQ(messages[1], 1);
+
+    /* Single shot without stretching */
+    model.set(21.5f, 40.0f);
+    float fT;
+    float fH;
+    CHECK(sht.runSingleShot(CMD_SS_CSD_HIGH, &fT, &fH));
+    CHECK_NEAR(fT, 21.5f, 0.05f);
+    CHECK_NEAR(fH, 40.0f, 0.05f);
+
+    /* Fetch command and read in one ioctl */
+    model.set(-0.5f, 55.0f);
+    CHECK(sht.startPeriodic(PER_RATE_10, REPEAT_HIGH));
+    delay(150);
+    Wire.getTransferCount();
+    combined = 0;
+    CHECK(sht.fetchPeriodic(&fT, &fH));
+    CHECK_EQ(Wire.getTransferCount(), 1);
+    CHECK_EQ(combined, 1);
+    CHECK_NEAR(fT, -0.5f, 0.05f);
+    CHECK_NEAR(fH, 55.0f, 0.05f);
+    CHECK(sht.stopPeriodic());
+
+    /* Missing sensor */
+    TD_SHT31 missing(0x45);
+    CHECK(missing.begin() == false);
+    CHECK(missing.isSensorConnected() == false);
+
+    return checkSummary("test_linux");
+}
@@ -0,0 +1,126 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file test_lock.cpp
+ * @brief Bus lock stress test, 16 threads measuring own sensors.
+ * @details Built with TD_SHT31_LINUX, real threads and real time. Hook
+ * counts transfers that overlap on the shared TwoWire. Without lock
+ * results are only reported, with TD_SHT31StdMutexLock every measurement
+ * must be correct and transfers must not overlap.
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31.h"
+#include "TD_SHT31Lock.h"
+#include "host/SHT31Model.h"
+#include "host/check.h"
+
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <atomic>
+#include <thread>
+
+#define THREADS             16
+#define MEASUREMENTS        50
+#define FIRST_ADDRESS       0x10
+
+static SHT31Model *models[THREADS];
+static std::atomic<int> inside(0);
+static std::atomic<int> overlaps(0);
+static std::atomic<int> good(0);
+static std::atomic<int> bad(0);
+
+static int transfer(struct i2c_rdwr_ioctl_data *data)
+{
+    if (inside.fetch_add(1) != 0)
+    {
+        overlaps++;
+    }
+    int retval = (int) data->nmsgs;
+    for (uint32_t i = 0; i < data->nmsgs; i++)
+    {
+        struct i2c_msg *msg = &data->msgs[i];
+        uint8_t index = (uint8_t) (msg->addr - FIRST_ADDRESS);
+        if (index >= THREADS)
+        {
+            retval = -1;
+            break;
+        }
+        bool ack;
+        if (msg->flags & I2C_M_RD)
+        {
+            ack = models[index]->read(msg->buf, (uint8_t) msg->len);
+        } else
+        {
+            ack = models[index]->write(msg->buf, (uint8_t) msg->len);
+        }
+        if (ack == false)
+        {
+            retval = -1;
+            break;
+        }
+    }
+    delayMicroseconds(20);              /* Bus time */
+    inside--;
+    return retval;
+}
+
+static void measure(uint8_t index, TD_SHT31Lock *lock)
+{
+    TD_SHT31 sht(FIRST_ADDRESS + index);
+    sht.setBusLock(lock);
+    sht.begin();
+    sht.getLastError();
+    for (uint8_t i = 0; i < MEASUREMENTS; i++)
+    {
+        TD_SHT31Measurement m = sht.measure(CMD_SS_CSD_LOW);
+        if (m.ok() && (m.rawTemperature == models[index]->rawT) &&
+            (m.rawHumidity == models[index]->rawH))
+        {
+            good++;
+        } else
+        {
+            bad++;
+        }
+    }
+}
+
+static void run(TD_SHT31Lock *lock)
+{
+    overlaps = 0;
+    good = 0;
+    bad = 0;
+    std::thread threads[THREADS];
+    for (uint8_t i = 0; i < THREADS; i++)
+    {
+        models[i] = new SHT31Model(FIRST_ADDRESS + i);
+        models[i]->setRaw((uint16_t) (0x6666 + i), (uint16_t) (0x8000 + i * 10));
+    }
+    for (uint8_t i = 0; i < THREADS; i++)
+    {
+        threads[i] = std::thread(measure, i, lock);
+    }
+    for (uint8_t i = 0; i < THREADS; i++)
+    {
+        threads[i].join();
+    }
+    for (uint8_t i = 0; i < THREADS; i++)
+    {
+        delete models[i];
+    }
+    printf("test_lock: %s lock, %d good, %d bad, %d overlapping transfers\n",
+           (lock != NULL) ? "with" : "without", good.load(), bad.load(), overlaps.load());
+}
+
+int main()
+{
+    Wire.setTransferHook(transfer);
+
+    /* Unprotected TwoWire is shared, outcome is only reported */
+    run(NULL);
+
+    TD_SHT31StdMutexLock lock;
+    run(&lock);
+    CHECK_EQ(overlaps.load(), 0);
+    CHECK_EQ(bad.load(), 0);
+    CHECK_EQ(good.load(), THREADS * MEASUREMENTS);
+    return checkSummary("test_lock");
+}
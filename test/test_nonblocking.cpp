@@ -0,0 +1,122 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file test_nonblocking.cpp
+ * @brief Start and poll paths make no blocking calls.
+ * @details delay and delayMicroseconds are counted by host core. Each call
+ * of start or poll must return after at most one bus transaction.
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31.h"
+#include "SHT31Model.h"
+#include "check.h"
+
+#define CALL_MAX_US         1000    /* One transaction at 100 kHz */
+
+static SHT31Model model(0x44);
+static uint32_t maxCallUs;
+
+static void begin(TD_SHT31 *sht)
+{
+    Wire.detachAll();
+    model = SHT31Model(0x44);
+    Wire.attach(&model);
+    CHECK(sht->begin(&Wire));
+    sht->getLastError();
+    hostDelayCalls = 0;
+    maxCallUs = 0;
+}
+
+static void track(uint64_t u64Start)
+{
+    uint32_t u32Elapsed = (uint32_t) (hostTime() - u64Start);
+    if (u32Elapsed > maxCallUs)
+    {
+        maxCallUs = u32Elapsed;
+    }
+}
+
+static void testSingleShot(bool adaptive)
+{
+    TD_SHT31 sht(0x44);
+    begin(&sht);
+    sht.setAdaptiveTiming(adaptive);
+
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        uint64_t u64Start = hostTime();
+        CHECK(sht.startSingleShot(CMD_SS_CSD_HIGH));
+        track(u64Start);
+
+        int16_t iT, iH;
+        uint8_t state;
+        uint32_t u32Polls = 0;
+        do
+        {
+            u64Start = hostTime();
+            state = sht.pollSingleShot(&iT, &iH);
+            track(u64Start);
+            u32Polls++;
+        } while (state == MEAS_PENDING);
+        CHECK_EQ(state, MEAS_READY);
+        CHECK(u32Polls > 1);
+    }
+    CHECK_EQ(hostDelayCalls, 0);
+    CHECK(maxCallUs < CALL_MAX_US);
+}
+
+static void testMeasurement()
+{
+    TD_SHT31 sht(0x44);
+    begin(&sht);
+
+    TD_SHT31Measurement m;
+    uint64_t u64Start = hostTime();
+    CHECK_EQ(sht.startMeasurement(CMD_SS_CSD_LOW, &m), MEAS_PENDING);
+    track(u64Start);
+    uint8_t state;
+    do
+    {
+        u64Start = hostTime();
+        state = sht.pollMeasurement(&m);
+        track(u64Start);
+    } while (state == MEAS_PENDING);
+    CHECK_EQ(state, MEAS_READY);
+    CHECK(m.ok());
+    CHECK_EQ(hostDelayCalls, 0);
+    CHECK(maxCallUs < CALL_MAX_US);
+}
+
+static void testPeriodic()
+{
+    TD_SHT31 sht(0x44);
+    begin(&sht);
+    CHECK(sht.startPeriodic(PER_RATE_10, REPEAT_LOW));
+    hostDelayCalls = 0;
+
+    /* Fetch without new sample is NACKed at once */
+    uint32_t u32Ready = 0;
+    uint64_t u64End = hostTime() + 350000;
+    while (hostTime() < u64End)
+    {
+        uint64_t u64Start = hostTime();
+        if (sht.fetch().ok())
+        {
+            u32Ready++;
+        }
+        track(u64Start);
+        hostAdvance(1000);
+    }
+    CHECK(u32Ready >= 3);
+    CHECK_EQ(hostDelayCalls, 0);
+    CHECK(maxCallUs < CALL_MAX_US);
+    sht.getLastError();
+}
+
+int main()
+{
+    testSingleShot(false);
+    testSingleShot(true);
+    testMeasurement();
+    testPeriodic();
+    return checkSummary("test_nonblocking");
+}
@@ -0,0 +1,143 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file test_psychro.cpp
+ * @brief TD_SHT31Psychro against reference formulas (double precision),
+ * error bounds as documented in TD_SHT31Psychro.h.
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31Psychro.h"
+#include "check.h"
+
+#include <chrono>
+
+static double saturation(double t)
+{
+    return 611.2 * exp(17.62 * t / (243.12 + t));
+}
+
+static double heatIndex(double c, double rh)
+{
+    double t = c * 1.8 + 32;
+    double hi = 0.5 * (t + 61.0 + (t - 68.0) * 1.2 + rh * 0.094);
+    if ((hi + t) * 0.5 >= 80.0)
+    {
+        hi = -42.379 + 2.04901523 * t + 10.14333127 * rh
+             - 0.22475541 * t * rh - 0.00683783 * t * t
+             - 0.05481717 * rh * rh + 0.00122874 * t * t * rh
+             + 0.00085282 * t * rh * rh - 0.00000199 * t * t * rh * rh;
+        if ((rh < 13.0) && (t > 80.0) && (t < 112.0))
+        {
+            hi -= ((13.0 - rh) * 0.25) * sqrt((17.0 - fabs(t - 95.0)) / 17.0);
+        } else if ((rh > 85.0) && (t > 80.0) && (t < 87.0))
+        {
+            hi += ((rh - 85.0) * 0.1) * ((87.0 - t) * 0.2);
+        }
+    }
+    return (hi - 32) / 1.8;
+}
+
+static volatile int32_t sink;
+static volatile float fSink;
+
+/**
+ * @brief Print ns per call of integer function and float reference.
+ * @details Speed is only reported, it depends on host CPU and FPU.
+*/
+template <typename Integer, typename Reference>
+static void compareSpeed(const char *name, Integer integer, Reference reference)
+{
+    typedef std::chrono::steady_clock clock;
+    const int32_t calls = 200000;
+    clock::time_point start = clock::now();
+    for (int32_t i = 0; i < calls; i++)
+    {
+        sink += integer((int16_t) (1000 + (i & 4095)), (int16_t) (2000 + (i & 8191)));
+    }
+    double nsInteger = std::chrono::duration<double, std::nano>(clock::now() - start).count() / calls;
+    start = clock::now();
+    for (int32_t i = 0; i < calls; i++)
+    {
+        fSink += reference((1000 + (i & 4095)) * 0.01f, (2000 + (i & 8191)) * 0.01f);
+    }
+    double nsReference = std::chrono::duration<double, std::nano>(clock::now() - start).count() / calls;
+    printf("test_psychro: %s %.1f ns, float reference %.1f ns\n", name, nsInteger, nsReference);
+}
+
+static int32_t dewPointInteger(int16_t iT, int16_t iH) { return TD_SHT31Psychro::dewPoint(iT, iH); }
+static int32_t absoluteInteger(int16_t iT, int16_t iH) { return TD_SHT31Psychro::absoluteHumidity(iT, iH); }
+static int32_t heatIndexInteger(int16_t iT, int16_t iH) { return TD_SHT31Psychro::heatIndex(iT, iH); }
+
+static float dewPointFloat(float t, float rh)
+{
+    float g = logf(rh * 0.01f) + 17.62f * t / (243.12f + t);
+    return 243.12f * g / (17.62f - g);
+}
+
+static float absoluteFloat(float t, float rh)
+{
+    return 2.16679f * 6.112f * expf(17.62f * t / (243.12f + t)) * rh / (273.15f + t);
+}
+
+static float heatIndexFloat(float c, float rh)
+{
+    float t = c * 1.8f + 32;
+    float hi = -42.379f + 2.04901523f * t + 10.14333127f * rh
+               - 0.22475541f * t * rh - 0.00683783f * t * t
+               - 0.05481717f * rh * rh + 0.00122874f * t * t * rh
+               + 0.00085282f * t * rh * rh - 0.00000199f * t * t * rh * rh;
+    return (hi - 32) / 1.8f;
+}
+
+int main()
+{
+    double esError = 0, dpError = 0, ahError = 0, hError = 0, hiError = 0;
+    for (int16_t iT = -4500; iT <= 8500; iT += 7)
+    {
+        double t = iT * 0.01;
+        double es = saturation(t);
+        double esDiff = fabs(TD_SHT31Psychro::saturationPressure(iT) - es) - 0.6;
+        esError = fmax(esError, esDiff / es);
+
+        for (int16_t iH = 100; iH <= 10000; iH += 97)
+        {
+            double e = es * iH * 0.0001;
+            double g = log(iH * 0.0001) + 17.62 * t / (243.12 + t);
+            double dp = 243.12 * g / (17.62 - g);
+            if ((dp > -45.0) && (dp < 85.0))
+            {
+                dpError = fmax(dpError, fabs(TD_SHT31Psychro::dewPoint(iT, iH) * 0.01 - dp));
+            }
+
+            double ah = 2.16679 * e / (273.15 + t);
+            double ahDiff = fabs(TD_SHT31Psychro::absoluteHumidity(iT, iH) * 0.01 - ah) - 0.01;
+            ahError = fmax(ahError, ahDiff / ah);
+
+            double w = 0.622 * e / (PSYCHRO_STD_PRESSURE - e);
+            double h = 1006 * t + w * (2501000 + 1860 * t);
+            double hDiff = fabs(TD_SHT31Psychro::enthalpy(iT, iH) - h) - 30;
+            hError = fmax(hError, hDiff / fabs(h));
+
+            double hi = fmin(heatIndex(t, iH * 0.01), 327.67);
+            hiError = fmax(hiError, fabs(TD_SHT31Psychro::heatIndex(iT, iH) * 0.01 - hi));
+        }
+    }
+    CHECK(esError <= 0.002);
+    CHECK(dpError <= 0.07);
+    CHECK(ahError <= 0.002);
+    CHECK(hError <= 0.0005);
+    CHECK(hiError <= 0.01);
+    printf("test_psychro: heat index worst error %.4f degC\n", hiError);
+
+    /* Input is limited to table range */
+    CHECK_EQ(TD_SHT31Psychro::saturationPressure(-6000), TD_SHT31Psychro::saturationPressure(-4500));
+    CHECK_EQ(TD_SHT31Psychro::dewPoint(8500, 10000), 8500);
+    CHECK_NEAR(TD_SHT31Psychro::heatIndex(3200, 7000), 4040, 60);
+    CHECK_EQ(TD_SHT31Psychro::heatIndex(20000, 5000), TD_SHT31Psychro::heatIndex(8500, 5000));
+
+    /* Table lookup and binary search against logf and expf */
+    compareSpeed("dewPoint", dewPointInteger, dewPointFloat);
+    compareSpeed("absoluteHumidity", absoluteInteger, absoluteFloat);
+    compareSpeed("heatIndex", heatIndexInteger, heatIndexFloat);
+
+    return checkSummary("test_psychro");
+}
@@ -0,0 +1,137 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file test_ring.cpp
+ * @brief TD_SHT31RingBuffer full/empty boundaries and index wraparound.
+ * @details Free running 8-bit indexes wrap after 256 samples, so every
+ * capacity is filled and drained well past that. Built with RING_BAD_N
+ * the capacity is invalid and compile must fail on static_assert.
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31RingBuffer.h"
+#include "check.h"
+
+#if defined(RING_BAD_N)
+TD_SHT31RingBuffer<RING_BAD_N> rejected;
+#else
+
+#define SAMPLES             1000
+
+static TD_SHT31Sample sample(uint32_t sequence)
+{
+    TD_SHT31Sample s;
+    s.timestamp   = sequence;
+    s.temperature = (uint16_t) (sequence * 3);
+    s.humidity    = (uint16_t) ~sequence;
+    return s;
+}
+
+static bool same(const TD_SHT31Sample &s, uint32_t sequence)
+{
+    return (s.timestamp == sequence) && (s.temperature == (uint16_t) (sequence * 3)) &&
+           (s.humidity == (uint16_t) ~sequence);
+}
+
+template <uint8_t N>
+static void testBoundaries()
+{
+    TD_SHT31RingBuffer<N> ring;
+    TD_SHT31Sample s;
+    TD_SHT31Sample out[N + 1];
+    uint32_t pushed = 0;
+    uint32_t popped = 0;
+    uint32_t errors = 0;
+    CHECK_EQ(ring.capacity(), N);
+
+    /* Fill to full and drain to empty, indexes wrap several times */
+    for (uint16_t round = 0; round < 600 / N; round++)
+    {
+        CHECK_EQ(ring.count(), 0);
+        CHECK(ring.pop(&s) == false);
+        CHECK_EQ(ring.pop(out, N), 0);
+        for (uint8_t i = 0; i < N; i++)
+        {
+            if (ring.push(sample(pushed)) == false)
+            {
+                errors++;
+            }
+            pushed++;
+        }
+        CHECK_EQ(ring.count(), N);
+        CHECK(ring.push(sample(pushed)) == false);
+        CHECK_EQ(ring.count(), N);
+
+        /* Larger max than stored returns only stored samples */
+        CHECK_EQ(ring.pop(out, N + 1), N);
+        for (uint8_t i = 0; i < N; i++)
+        {
+            if (same(out[i], popped) == false)
+            {
+                errors++;
+            }
+            popped++;
+        }
+    }
+    CHECK(pushed > 256);
+    CHECK_EQ(errors, 0);
+}
+
+template <uint8_t N>
+static void testStreaming()
+{
+    TD_SHT31RingBuffer<N> ring;
+    TD_SHT31Sample s;
+    TD_SHT31Sample out[3];
+    uint32_t pushed = 0;
+    uint32_t popped = 0;
+    uint32_t errors = 0;
+
+    /* Producer two ahead of consumer at every head/tail offset */
+    for (uint32_t i = 0; i < SAMPLES; i++)
+    {
+        if (ring.push(sample(pushed)))
+        {
+            pushed++;
+        }
+        if (ring.push(sample(pushed)))
+        {
+            pushed++;
+        }
+        uint8_t n = ring.pop(out, (i & 1) ? 3 : 1);
+        for (uint8_t j = 0; j < n; j++)
+        {
+            if (same(out[j], popped) == false)
+            {
+                errors++;
+            }
+            popped++;
+        }
+        if (ring.count() != (uint8_t) (pushed - popped))
+        {
+            errors++;
+        }
+    }
+    while (ring.pop(&s))
+    {
+        if (same(s, popped) == false)
+        {
+            errors++;
+        }
+        popped++;
+    }
+    CHECK(pushed > 256);
+    CHECK_EQ(popped, pushed);
+    CHECK_EQ(ring.count(), 0);
+    CHECK_EQ(errors, 0);
+}
+
+int main()
+{
+    testBoundaries<2>();
+    testBoundaries<4>();
+    testBoundaries<128>();
+    testStreaming<4>();
+    testStreaming<128>();
+    return checkSummary("test_ring");
+}
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file test_scheduler.cpp
+ * @brief TD_SHT31Scheduler with simulated sensors.
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31.h"
+#include "TD_SHT31Scheduler.h"
+#include "SHT31Model.h"
+#include "check.h"
+
+static uint16_t results[2];
+static uint16_t failures[2];
+static uint16_t lastStatus[2];
+
+static void onResult(uint8_t index, const TD_SHT31Measurement *result)
+{
+    results[index]++;
+    if (result->ok() == false)
+    {
+        failures[index]++;
+    }
+    lastStatus[index] = result->status;
+}
+
+int main()
+{
+    SHT31Model model(0x44);
+    Wire.attach(&model);
+    TD_SHT31 sht(0x44);
+    TD_SHT31 missing(0x45);
+    CHECK(sht.begin(&Wire));
+    missing.begin(&Wire);
+    missing.getLastError();
+
+    /* Sticky error of user before scheduler runs */
+    CHECK(missing.startSingleShot(CMD_PER_1_HIGH) == false);
+
+    TD_SHT31Scheduler scheduler;
+    CHECK(scheduler.addSensor(&sht, CMD_SS_CSD_HIGH));
+    CHECK(scheduler.addSensor(&missing, CMD_SS_CSD_HIGH));
+    scheduler.setCallback(onResult);
+    scheduler.setPeriod(100000UL);
+
+    uint64_t u64End = hostTime() + 350000;
+    while (hostTime() < u64End)
+    {
+        scheduler.service();
+    }
+
+    CHECK(results[0] >= 3);
+    CHECK_EQ(failures[0], 0);
+    CHECK_EQ(results[1], results[0]);
+    CHECK_EQ(failures[1], results[1]);
+
+    /* Failed start reports only its own error, sticky error is kept */
+    CHECK_EQ(lastStatus[1], ERROR_END_TRANSMISSION);
+    CHECK_EQ(missing.getLastError(), ERROR_WRONG_COMMAND | ERROR_END_TRANSMISSION);
+    CHECK_EQ(hostDelayCalls, 0);
+
+    TD_SHT31Jitter jitter;
+    scheduler.getJitter(&jitter, true);
+    CHECK_EQ(jitter.count, results[0]);
+    CHECK_EQ(jitter.overruns, 0);
+
+    return checkSummary("test_scheduler");
+}
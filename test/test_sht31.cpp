@@ -0,0 +1,587 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file test_sht31.cpp
+ * @brief TD_SHT31 against simulated SHT31 on host TwoWire.
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31.h"
+#include "TD_SHT31Transport.h"
+#include "SHT31Model.h"
+#include "check.h"
+
+static SHT31Model model(0x44);
+
+static void setup(TD_SHT31 *sht)
+{
+    Wire.detachAll();
+    model = SHT31Model(0x44);
+    Wire.attach(&model);
+    CHECK(sht->begin(&Wire));
+    sht->getLastError();
+}
+
+static void testSingleShot()
+{
+    TD_SHT31 sht(0x44);
+    setup(&sht);
+    CHECK(sht.isSensorConnected());
+
+    static const uint16_t COMMANDS[3] = { CMD_SS_CSD_HIGH, CMD_SS_CSD_MEDIUM, CMD_SS_CSD_LOW };
+    static const uint32_t MAX_US[3] = { 16000, 7000, 5000 };
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        uint64_t u64Start = hostTime();
+        int16_t iT, iH;
+        CHECK(sht.runSingleShot(COMMANDS[i], &iT, &iH));
+        uint64_t u64Elapsed = hostTime() - u64Start;
+        CHECK_NEAR(iT, 2345, 1);
+        CHECK_NEAR(iH, 4567, 1);
+        CHECK(u64Elapsed >= MAX_US[i]);
+        CHECK(u64Elapsed < MAX_US[i] + 1000);
+        CHECK_EQ(model.lastCommand, COMMANDS[i]);
+    }
+    CHECK_EQ(model.conversions, 3);
+    CHECK_EQ(sht.getLastError(), NO_ERROR);
+
+    float fT, fH;
+    model.set(-10.5f, 99.0f);
+    CHECK(sht.runSingleShot(CMD_SS_CSD_LOW, &fT, &fH));
+    CHECK_NEAR(fT, -10.5, 0.01);
+    CHECK_NEAR(fH, 99.0, 0.01);
+
+    sht.set_defaults(ENABLE_CRC, FARENHEIT);
+    model.set(100.0f, 50.0f);
+    TD_SHT31Measurement m = sht.measure(CMD_SS_CSD_HIGH);
+    CHECK(m.ok());
+    CHECK_NEAR(m.temperature, 21200, 1);
+    CHECK_NEAR(m.humidity, 5000, 1);
+
+    /* Wrong command and missing sensor */
+    CHECK(sht.startSingleShot(CMD_PER_1_HIGH) == false);
+    CHECK_EQ(sht.getLastError(), ERROR_WRONG_COMMAND);
+    TD_SHT31 missing(0x45);
+    CHECK(missing.begin(&Wire) == false);
+    CHECK(missing.isSensorConnected() == false);
+    CHECK(missing.measure(CMD_SS_CSD_HIGH).status & ERROR_END_TRANSMISSION);
+}
+
+static void testClockStretching()
+{
+    TD_SHT31 sht(0x44);
+    setup(&sht);
+
+    /* Read is issued at once, sensor holds SCL until conversion is done */
+    uint64_t u64Start = hostTime();
+    TD_SHT31Measurement m = sht.measure(CMD_SS_CSE_HIGH);
+    uint64_t u64Elapsed = hostTime() - u64Start;
+    CHECK(m.ok());
+    CHECK_NEAR(m.temperature, 2345, 1);
+    CHECK(u64Elapsed >= model.conversionUs[REPEAT_HIGH]);
+    CHECK(u64Elapsed < model.conversionUs[REPEAT_HIGH] + 1000);
+    CHECK_EQ(model.busyNacks, 0);
+
+    /* Stretch longer than bus timeout */
+    sht.setBusTimeout(5000);
+    m = sht.measure(CMD_SS_CSE_HIGH);
+    CHECK(m.ok() == false);
+    CHECK(m.status & ERROR_FM_TIMEOUT);
+    CHECK(m.status & ERROR_REQUEST_LEN);
+    delay(10);
+    sht.setBusTimeout(20000);
+    CHECK(sht.measure(CMD_SS_CSE_LOW).ok());
+}
+
+static void testAdaptiveTiming()
+{
+    TD_SHT31 sht(0x44);
+    setup(&sht);
+    model.conversionUs[REPEAT_HIGH] = 11000;
+    sht.setAdaptiveTiming(true);
+
+    /* Initial estimate is too long, shrinks towards actual time */
+    uint64_t u64Elapsed = 0;
+    for (uint8_t i = 0; i < 40; i++)
+    {
+        uint64_t u64Start = hostTime();
+        TD_SHT31Measurement m = sht.measure(CMD_SS_CSD_HIGH);
+        u64Elapsed = hostTime() - u64Start;
+        CHECK(m.ok());
+    }
+    CHECK(sht.getConversionTime(REPEAT_HIGH) >= 11000 - 11000 / 16 - 200);
+    CHECK(sht.getConversionTime(REPEAT_HIGH) < 11000 + 2 * ADAPTIVE_RETRY_US);
+    CHECK(u64Elapsed < 11000 + 3 * ADAPTIVE_RETRY_US + 1000);
+    CHECK(model.busyNacks > 0);
+
+    /* Sensor slows down: NACKed reads are retried and counted. Estimate is
+       start of read, read header takes 100 us at 100 kHz. */
+    model.conversionUs[REPEAT_HIGH] = 13000;
+    TD_SHT31Measurement m = sht.measure(CMD_SS_CSD_HIGH);
+    CHECK(m.ok());
+    CHECK(m.retries > 0);
+    CHECK(sht.getConversionTime(REPEAT_HIGH) >= 13000 - 200);
+    CHECK(sht.getConversionTime(REPEAT_HIGH) <= 13000 + 2 * ADAPTIVE_RETRY_US);
+
+    /* Not ready at datasheet maximum: failure reports no retries */
+    model.conversionUs[REPEAT_HIGH] = 20000;
+    m = sht.measure(CMD_SS_CSD_HIGH);
+    CHECK(m.ok() == false);
+    CHECK_EQ(m.retries, 0);
+    delay(10);
+
+    /* Poll without start */
+    TD_SHT31 fresh(0x44);
+    m.retries = 0xAA;
+    CHECK_EQ(fresh.pollMeasurement(&m), MEAS_FAILED);
+    CHECK_EQ(m.retries, 0);
+    CHECK_EQ(m.status, ERROR_WRONG_COMMAND);
+}
+
+static void testAdaptiveLimits()
+{
+    TD_SHT31 sht(0x44);
+    setup(&sht);
+    sht.setAdaptiveTiming(true);
+
+    /* Ready only at datasheet maximum: fallback read is learned */
+    model.conversionUs[REPEAT_HIGH] = 15950;
+    TD_SHT31Measurement m = sht.measure(CMD_SS_CSD_HIGH);
+    CHECK(m.ok());
+    CHECK(m.retries > 0);
+    CHECK(sht.getConversionTime(REPEAT_HIGH) >= 15900);
+
+    /* Estimate at maximum still shrinks when read succeeds at once */
+    model.conversionUs[REPEAT_HIGH] = 10000;
+    CHECK(sht.measure(CMD_SS_CSD_HIGH).ok());
+    CHECK(sht.getConversionTime(REPEAT_HIGH) < 15900);
+
+    /* First poll long after start (wait does not fit 16 bits) and sensor
+       gone: final read at once instead of endless retries */
+    uint16_t u16T, u16H;
+    CHECK(sht.startSingleShot(CMD_SS_CSD_HIGH));
+    delay(70);
+    model.nackNext = 255;
+    uint8_t state = MEAS_PENDING;
+    uint8_t polls = 0;
+    while ((state == MEAS_PENDING) && (polls < 10))
+    {
+        state = sht.pollSingleShotRaw(&u16T, &u16H);
+        polls++;
+    }
+    CHECK_EQ(state, MEAS_FAILED);
+    CHECK_EQ(polls, 1);
+    CHECK(sht.getLastError() & ERROR_REQUEST_LEN);
+    model.nackNext = 0;
+
+    /* NACK before maximum: retried, then read at maximum */
+    TD_SHT31 fresh(0x44);
+    CHECK(fresh.begin(&Wire));
+    fresh.setAdaptiveTiming(true);
+    model.conversionUs[REPEAT_HIGH] = 11000;
+    CHECK(fresh.startSingleShot(CMD_SS_CSD_HIGH));
+    delay(15);
+    model.nackNext = 1;
+    CHECK_EQ(fresh.pollSingleShotRaw(&u16T, &u16H), MEAS_PENDING);
+    delay(1);
+    CHECK_EQ(fresh.pollSingleShotRaw(&u16T, &u16H), MEAS_READY);
+    CHECK(fresh.getConversionTime(REPEAT_HIGH) >= 16000 - 100);
+}
+
+static void testPeriodic()
+{
+    TD_SHT31 sht(0x44);
+    setup(&sht);
+
+    CHECK(sht.startPeriodic(PER_RATE_10, REPEAT_HIGH));
+    CHECK_EQ(sht.getMode(), MODE_PERIODIC);
+    CHECK_EQ(model.mode(), MODEL_PERIODIC);
+
+    /* No sample yet, fetch is NACKed */
+    TD_SHT31Measurement m = sht.fetch();
+    CHECK(m.ok() == false);
+    CHECK(m.status & ERROR_REQUEST_LEN);
+
+    delay(20);
+    m = sht.fetch();
+    CHECK(m.ok());
+    CHECK_NEAR(m.temperature, 2345, 1);
+    CHECK(sht.fetch().ok() == false);
+    delay(100);
+    CHECK(sht.fetch().ok());
+
+    /* Single shot is rejected in periodic mode */
+    sht.getLastError();
+    CHECK(sht.startSingleShot(CMD_SS_CSD_HIGH) == false);
+    CHECK_EQ(sht.getLastError(), ERROR_WRONG_COMMAND);
+
+    TD_SHT31RingBuffer<4> buffer;
+    delay(100);
+    CHECK(sht.fetchPeriodic(&buffer));
+    CHECK_EQ(buffer.count(), 1);
+
+    CHECK(sht.stopPeriodic());
+    CHECK_EQ(sht.getMode(), MODE_IDLE);
+    CHECK_EQ(model.mode(), MODEL_IDLE);
+    CHECK(sht.fetch().status & ERROR_WRONG_COMMAND);
+    CHECK(sht.measure(CMD_SS_CSD_LOW).ok());
+}
+
+static void testART()
+{
+    TD_SHT31 sht(0x44);
+    setup(&sht);
+
+    CHECK(sht.enableART());
+    CHECK_EQ(sht.getMode(), MODE_ART);
+    CHECK_EQ(model.mode(), MODEL_ART);
+    delay(20);
+    CHECK(sht.fetch().ok());
+    CHECK(sht.fetch().ok() == false);
+    delay(250);
+    CHECK(sht.fetch().ok());
+
+    /* Periodic start stops ART first */
+    CHECK(sht.startPeriodic(PER_RATE_1, REPEAT_LOW));
+    CHECK_EQ(model.mode(), MODEL_PERIODIC);
+    CHECK_EQ(model.lastCommand, CMD_PER_1_LOW);
+    CHECK(sht.stopPeriodic());
+}
+
+static void testStatus()
+{
+    TD_SHT31 sht(0x44);
+    setup(&sht);
+
+    CHECK_EQ(sht.readSensorStatus(), MODEL_STATUS_RESET);
+    CHECK(sht.clearSensorStatus());
+    CHECK_EQ(sht.readSensorStatus(), 0x0000);
+
+    /* Reset sets reset detected bit again */
+    CHECK(sht.resetSensor(CMD_SOFT_RESET));
+    delay(2);
+    CHECK_EQ(sht.readSensorStatus(), MODEL_STATUS_RESET);
+    CHECK_EQ(sht.getLastError(), NO_ERROR);
+
+    model.corruptCrc = 1;
+    CHECK_EQ(sht.readSensorStatus(), 0xFFFF);
+    CHECK_EQ(sht.getLastError(), ERROR_CRC_CHECK);
+}
+
+static void testCrcFailure()
+{
+    TD_SHT31 sht(0x44);
+    setup(&sht);
+
+    model.corruptCrc = 1;
+    TD_SHT31Measurement m = sht.measure(CMD_SS_CSD_HIGH);
+    CHECK(m.ok() == false);
+    CHECK_EQ(m.status, ERROR_CRC_CHECK);
+    CHECK_EQ(m.temperature, 0);
+    CHECK(sht.measure(CMD_SS_CSD_HIGH).ok());
+
+    /* CRC check disabled: corrupted checksum is accepted */
+    sht.set_defaults(DISABLE_CRC, CELSIUS);
+    model.corruptCrc = 1;
+    m = sht.measure(CMD_SS_CSD_HIGH);
+    CHECK(m.ok());
+    CHECK_NEAR(m.temperature, 2345, 1);
+}
+
+static void testBusyNack()
+{
+    TD_SHT31 sht(0x44);
+    setup(&sht);
+
+    /* Sensor NACKs commands and reads while converting */
+    CHECK(sht.startSingleShot(CMD_SS_CSD_HIGH));
+    CHECK_EQ(sht.readSensorStatus(), 0xFFFF);
+    CHECK(sht.getLastError() & ERROR_END_TRANSMISSION);
+    CHECK(model.busyNacks > 0);
+
+    uint16_t u16T, u16H;
+    uint8_t state;
+    while ((state = sht.pollSingleShotRaw(&u16T, &u16H)) == MEAS_PENDING)
+    {
+        ;
+    }
+    CHECK_EQ(state, MEAS_READY);
+    CHECK_EQ(u16T, model.rawT);
+    CHECK_EQ(u16H, model.rawH);
+
+    /* Data is read once, next read is NACKed */
+    CHECK(Wire.requestFrom((uint8_t) 0x44, (uint8_t) 6) == 0);
+
+    /* Transient NACK is retried */
+    sht.setRetryPolicy(3, 1, RETRY_NONE);
+    model.nackNext = 1;
+    CHECK(sht.measure(CMD_SS_CSD_LOW).ok());
+    CHECK_EQ(sht.getRetryCount(), 1);
+}
+
+static uint32_t pinCalls;
+
+static void onPin(uint8_t pin)
+{
+    (void) pin;
+    pinCalls++;
+}
+
+static void testRetryEscalation()
+{
+    TD_SHT31 sht(0x44);
+    setup(&sht);
+    sht.set_defaults(ENABLE_CRC, CELSIUS, 4, 5);
+    sht.setRetryPolicy(3, 0, RETRY_BUS_RECOVERY | RETRY_SOFT_RESET);
+    hostPinHook = onPin;
+
+    /* Attempt 1 fails: bus recovery, attempt 2 fails: soft reset */
+    pinCalls = 0;
+    model.nackWrites = 2;
+    CHECK(sht.measure(CMD_SS_CSD_LOW).ok());
+    CHECK(pinCalls > 0);
+    CHECK_EQ(model.resets, 1);
+    CHECK_EQ(sht.getRetryCount(), 2);
+    CHECK_EQ(sht.getRecoveryCount(), 2);
+
+    /* Soft reset would stop periodic mode, only bus recovery */
+    CHECK(sht.startPeriodic(PER_RATE_10, REPEAT_LOW));
+    pinCalls = 0;
+    model.nackWrites = 2;
+    CHECK(sht.stopPeriodic());
+    CHECK(pinCalls > 0);
+    CHECK_EQ(model.resets, 1);
+    CHECK_EQ(model.lastCommand, CMD_PER_BREAK);
+    CHECK_EQ(sht.getRetryCount(), 4);
+    CHECK_EQ(sht.getRecoveryCount(), 3);
+
+    /* Without pins bus recovery is skipped */
+    sht.set_defaults(ENABLE_CRC, CELSIUS, NO_PIN, NO_PIN);
+    pinCalls = 0;
+    model.nackWrites = 1;
+    CHECK(sht.measure(CMD_SS_CSD_LOW).ok());
+    CHECK_EQ(pinCalls, 0);
+    CHECK_EQ(sht.getRetryCount(), 5);
+    CHECK_EQ(sht.getRecoveryCount(), 3);
+    hostPinHook = NULL;
+}
+
+static void testTransport()
+{
+    TD_SHT31 sht(0x44);
+    setup(&sht);
+    TD_SHT31WireTransport transport(&Wire);
+    sht.setTransport(&transport);
+
+    CHECK(sht.isSensorConnected());
+    TD_SHT31Measurement m = sht.measure(CMD_SS_CSD_HIGH);
+    CHECK(m.ok());
+    CHECK_NEAR(m.temperature, 2345, 1);
+    CHECK(sht.measure(CMD_SS_CSE_LOW).ok());
+    CHECK_EQ(sht.readSensorStatus(), MODEL_STATUS_RESET);
+    CHECK(sht.startPeriodic(PER_RATE_10, REPEAT_LOW));
+    delay(10);
+    CHECK(sht.fetch().ok());
+    CHECK(sht.stopPeriodic());
+    CHECK(transport.isIdle());
+}
+
+static void testBusBytes()
+{
+    TD_SHT31 sht(0x44);
+    setup(&sht);
+    sht.getBusBytes();
+    Wire.bytes = 0;
+
+    /* Adaptive timing, command NACKed while converting */
+    sht.setAdaptiveTiming(true);
+    CHECK(sht.measure(CMD_SS_CSD_HIGH).ok());
+    CHECK(sht.startSingleShot(CMD_SS_CSD_HIGH));
+    CHECK_EQ(sht.readSensorStatus(), 0xFFFF);
+    CHECK(model.busyNacks > 0);
+    TD_SHT31Measurement m;
+    while (sht.pollMeasurement(&m) == MEAS_PENDING)
+    {
+        ;
+    }
+    CHECK(m.ok());
+    CHECK_EQ(sht.getBusBytes(), Wire.bytes);
+    Wire.bytes = 0;
+
+    /* Retried NACK, status read, periodic fetch */
+    sht.setRetryPolicy(3, 1, RETRY_NONE);
+    model.nackNext = 1;
+    CHECK(sht.measure(CMD_SS_CSD_LOW).ok());
+    CHECK(sht.readSensorStatus() != 0xFFFF);
+    CHECK(sht.startPeriodic(PER_RATE_10, REPEAT_LOW));
+    delay(10);
+    CHECK(sht.fetch().ok());
+    CHECK(sht.fetch().ok() == false);
+    CHECK(sht.stopPeriodic());
+    CHECK_EQ(sht.getBusBytes(), Wire.bytes);
+    CHECK_EQ(sht.getBusBytes(), 0);
+
+    /* Failures through transport */
+    TD_SHT31WireTransport transport(&Wire);
+    TD_SHT31 missing(0x45);
+    missing.setTransport(&transport);
+    Wire.bytes = 0;
+    CHECK(missing.begin(&Wire) == false);
+    CHECK(missing.measure(CMD_SS_CSD_HIGH).ok() == false);
+    CHECK_EQ(missing.getBusBytes(), Wire.bytes);
+    CHECK(Wire.bytes > 0);
+}
+
+/**
+ * @brief Measure raw codes, return calibrated temperature and humidity.
+*/
+static TD_SHT31Measurement measureRaw(TD_SHT31 *sht, uint16_t u16T, uint16_t u16H)
+{
+    model.setRaw(u16T, u16H);
+    TD_SHT31Measurement m = sht->measure(CMD_SS_CSD_LOW);
+    CHECK(m.ok());
+    return m;
+}
+
+/**
+ * @brief Expected value of Q14 calibration, limited to int16_t.
+*/
+static int32_t expected(int16_t value, uint16_t gain, int16_t offset)
+{
+    int32_t result = (int32_t) floor(value * (double) gain / CAL_GAIN_ONE + 0.5) + offset;
+    return (result > 32767) ? 32767 : ((result < -32768) ? -32768 : result);
+}
+
+static void testCalibration()
+{
+    TD_SHT31 sht(0x44);
+    setup(&sht);
+    TD_SHT31Calibration cal;
+
+    /* Identity */
+    CHECK(sht.setTwoPointCalibration(false, 1000, 1000, 3000, 3000));
+    sht.getCalibration(&cal);
+    CHECK_EQ(cal.tGain, CAL_GAIN_ONE);
+    CHECK_EQ(cal.tOffset, 0);
+    TD_SHT31Measurement m = measureRaw(&sht, 0x6000, 0x8000);
+    CHECK_EQ(m.temperature, TD_SHT31::ticksToCentiCelsius(0x6000));
+    CHECK_EQ(m.humidity, TD_SHT31::ticksToCentiHumidity(0x8000));
+
+    /* Single point offset */
+    cal.tOffset = -50;
+    cal.hOffset = 120;
+    sht.setCalibration(&cal);
+    m = measureRaw(&sht, 0x6000, 0x8000);
+    CHECK_EQ(m.temperature, TD_SHT31::ticksToCentiCelsius(0x6000) - 50);
+    CHECK_EQ(m.humidity, TD_SHT31::ticksToCentiHumidity(0x8000) + 120);
+
+    /* Two points, offset rounded as in calibrate */
+    CHECK(sht.setTwoPointCalibration(false, 1000, 1100, 3000, 3050));
+    sht.getCalibration(&cal);
+    CHECK_EQ(cal.tGain, 15974);
+    CHECK_EQ(cal.tOffset, 125);
+    CHECK_EQ(cal.hOffset, 120);
+
+    /* Calibrated measurement hits reference at measured points */
+    for (uint16_t u16Raw1 = 0x1000; u16Raw1 < 0x8000; u16Raw1 += 0x0F13)
+    {
+        uint16_t u16Raw2 = u16Raw1 + 0x5123;
+        int16_t m1 = TD_SHT31::ticksToCentiCelsius(u16Raw1);
+        int16_t m2 = TD_SHT31::ticksToCentiCelsius(u16Raw2);
+        int16_t h1 = TD_SHT31::ticksToCentiHumidity(u16Raw1);
+        int16_t h2 = TD_SHT31::ticksToCentiHumidity(u16Raw2);
+        int16_t r1 = (int16_t) (m1 + 37);
+        int16_t r2 = (int16_t) (m1 + 37 + (m2 - m1) * 9 / 10);
+        CHECK(sht.setTwoPointCalibration(false, m1, r1, m2, r2));
+        CHECK(sht.setTwoPointCalibration(true, h2, h2 - 80, h1, h1 + 15));
+        sht.getCalibration(&cal);
+        m = measureRaw(&sht, u16Raw1, u16Raw1);
+        CHECK_EQ(m.temperature, r1);
+        CHECK_EQ(m.humidity, expected(h1, cal.hGain, cal.hOffset));
+        m = measureRaw(&sht, u16Raw2, u16Raw2);
+        CHECK_NEAR(m.temperature, r2, 1);
+        CHECK_EQ(m.humidity, h2 - 80);
+        CHECK_EQ(m.temperature, expected(m2, cal.tGain, cal.tOffset));
+    }
+
+    /* Negative values, points in reverse order */
+    CHECK(sht.setTwoPointCalibration(false, -1000, -1010, -2000, -1900));
+    sht.getCalibration(&cal);
+    CHECK_EQ(cal.tGain, 14582);
+    m = measureRaw(&sht, 0x1000, 0x8000);
+    CHECK_EQ(m.temperature, expected(TD_SHT31::ticksToCentiCelsius(0x1000),
+                                     cal.tGain, cal.tOffset));
+
+    /* Rejected: equal points, negative slope, gain 4.0 and above */
+    TD_SHT31Calibration before = cal;
+    CHECK(sht.setTwoPointCalibration(false, 1000, 1000, 1000, 2000) == false);
+    CHECK(sht.setTwoPointCalibration(false, 1000, 3000, 3000, 1000) == false);
+    CHECK(sht.setTwoPointCalibration(false, 1000, 1000, 1000, 1000) == false);
+    CHECK(sht.setTwoPointCalibration(true, 0, 0, 100, 400) == false);
+    sht.getCalibration(&cal);
+    CHECK_EQ(cal.tGain, before.tGain);
+    CHECK_EQ(cal.tOffset, before.tOffset);
+    CHECK(sht.setTwoPointCalibration(true, 0, 0, 100, 399));
+
+    /* Result saturates at int16_t range */
+    cal.tGain   = 0xFFFF;
+    cal.tOffset = 32767;
+    cal.hGain   = 0xFFFF;
+    cal.hOffset = -32768;
+    sht.setCalibration(&cal);
+    m = measureRaw(&sht, 0xFFFF, 0);
+    CHECK_EQ(m.temperature, 32767);
+    CHECK_EQ(m.humidity, -32768);
+    m = measureRaw(&sht, 0, 0xFFFF);
+    CHECK_EQ(m.temperature, expected(-4500, 0xFFFF, 32767));
+    CHECK_EQ(m.humidity, expected(10000, 0xFFFF, -32768));
+}
+
+static void testClock()
+{
+    static const uint32_t CLOCKS[3] = { I2C_CLOCK_100K, I2C_CLOCK_400K, I2C_CLOCK_1M };
+    uint32_t u32Time[3];
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        /* begin(TwoWire *, uint32_t) */
+        TD_SHT31 sht(0x44);
+        Wire.setClock(0);
+        CHECK(sht.begin(&Wire, CLOCKS[i]));
+        CHECK_EQ(Wire.clock(), CLOCKS[i]);
+
+        /* setClock after begin, before begin */
+        Wire.setClock(0);
+        sht.setClock(CLOCKS[i]);
+        CHECK_EQ(Wire.clock(), CLOCKS[i]);
+        TD_SHT31 late(0x44);
+        late.setClock(CLOCKS[i]);
+        Wire.setClock(0);
+        CHECK(late.begin(&Wire));
+        CHECK_EQ(Wire.clock(), CLOCKS[i]);
+
+        /* Status command and 3 byte read */
+        uint64_t u64Start = hostTime();
+        CHECK(sht.readSensorStatus() != 0xFFFF);
+        u32Time[i] = (uint32_t) (hostTime() - u64Start);
+    }
+    CHECK(u32Time[1] < u32Time[0]);
+    CHECK(u32Time[2] < u32Time[0]);
+    CHECK(u32Time[2] < u32Time[1]);
+}
+
+int main()
+{
+    testSingleShot();
+    testClockStretching();
+    testAdaptiveTiming();
+    testAdaptiveLimits();
+    testPeriodic();
+    testART();
+    testStatus();
+    testCrcFailure();
+    testBusyNack();
+    testRetryEscalation();
+    testTransport();
+    testBusBytes();
+    testClock();
+    testCalibration();
+    return checkSummary("test_sht31");
+}
@@ -0,0 +1,214 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file test_statistics.cpp
+ * @brief TD_SHT31Statistics and TD_SHT31RollingStatistics against double
+ * precision reference over stored samples.
+ * @details Mean within 0.5 LSB, variance within 1 LSB (truncated),
+ * deviation within 1 LSB (floor of square root).
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31Statistics.h"
+#include "check.h"
+
+#define SAMPLES             1000
+
+static int16_t samples[SAMPLES][2];
+static uint32_t seed = 1;
+
+static int16_t next(int16_t min, int16_t max)
+{
+    seed = seed * 1103515245UL + 12345;
+    return (int16_t) (min + (int32_t) ((seed >> 8) % (uint32_t) (max - min + 1)));
+}
+
+/**
+ * @brief Compare summary with reference of samples[first...first + count - 1].
+*/
+static void compare(const TD_SHT31Summary *s, uint16_t first, uint16_t count)
+{
+    for (uint8_t q = 0; q < 2; q++)
+    {
+        double sum = 0;
+        int16_t min = samples[first][q];
+        int16_t max = min;
+        for (uint16_t i = first; i < first + count; i++)
+        {
+            sum += samples[i][q];
+            min = (samples[i][q] < min) ? samples[i][q] : min;
+            max = (samples[i][q] > max) ? samples[i][q] : max;
+        }
+        double mean = sum / count;
+        double variance = 0;
+        for (uint16_t i = first; i < first + count; i++)
+        {
+            variance += (samples[i][q] - mean) * (samples[i][q] - mean);
+        }
+        variance = (count > 1) ? variance / (count - 1) : 0;
+
+        CHECK_EQ((q == 0) ? s->tMin : s->hMin, min);
+        CHECK_EQ((q == 0) ? s->tMax : s->hMax, max);
+        CHECK_NEAR((q == 0) ? s->tMean : s->hMean, mean, 0.5);
+        CHECK_NEAR((q == 0) ? s->tVariance : s->hVariance, variance, 1.0);
+        CHECK_NEAR((q == 0) ? s->tDeviation : s->hDeviation, sqrt(variance), 1.0);
+    }
+    CHECK_EQ(s->count, count);
+}
+
+static void testCumulative()
+{
+    TD_SHT31Statistics stats;
+    TD_SHT31Summary s;
+    CHECK(stats.getSummary(&s) == false);
+    for (uint16_t i = 0; i < SAMPLES; i++)
+    {
+        stats.add(samples[i][0], samples[i][1]);
+    }
+    CHECK(stats.getSummary(&s));
+    compare(&s, 0, SAMPLES);
+    CHECK(stats.getWindow(&s) == false);
+
+    /* Single sample has no variance */
+    stats.clear();
+    stats.add(-4500, 0);
+    CHECK(stats.getSummary(&s));
+    CHECK_EQ(s.tMean, -4500);
+    CHECK_EQ(s.tVariance, 0);
+}
+
+static void testTumbling()
+{
+    TD_SHT31Statistics stats(100);
+    TD_SHT31Summary s;
+    for (uint16_t i = 0; i < SAMPLES; i++)
+    {
+        stats.add(samples[i][0], samples[i][1]);
+        if ((i % 100) == 99)
+        {
+            /* Latched once per window */
+            CHECK(stats.getWindow(&s));
+            compare(&s, (uint16_t) (i - 99), 100);
+            CHECK(stats.getWindow(&s) == false);
+            CHECK_EQ(stats.count(), 0);
+        } else if ((i % 100) == 50)
+        {
+            CHECK(stats.getWindow(&s) == false);
+            CHECK(stats.getSummary(&s));
+            compare(&s, (uint16_t) (i - 50), 51);
+        }
+    }
+
+    /* setWindow clears */
+    stats.add(0, 0);
+    stats.setWindow(STATS_CUMULATIVE);
+    CHECK_EQ(stats.count(), 0);
+}
+
+template <uint8_t N>
+static void testRolling()
+{
+    TD_SHT31RollingStatistics<N> stats;
+    TD_SHT31Summary s;
+    for (uint16_t i = 0; i < SAMPLES; i++)
+    {
+        stats.add(samples[i][0], samples[i][1]);
+        uint16_t count = (i < N) ? (uint16_t) (i + 1) : N;
+        if (((i % 37) == 0) || (i == N - 1) || (i == N) || (i == SAMPLES - 1))
+        {
+            CHECK(stats.getSummary(&s));
+            compare(&s, (uint16_t) (i + 1 - count), count);
+        }
+    }
+
+    /* Extremes evicted: ramp down then constant */
+    stats.clear();
+    for (int16_t i = 0; i < 3 * N; i++)
+    {
+        stats.add((i < N) ? (int16_t) (1000 - i) : 0, 0);
+    }
+    CHECK(stats.getSummary(&s));
+    CHECK_EQ(s.tMin, 0);
+    CHECK_EQ(s.tMax, 0);
+    CHECK_EQ(s.tVariance, 0);
+
+    /* Window stays N samples */
+    TD_SHT31Statistics *base = &stats;
+    base->setWindow(10);
+    for (uint16_t i = 0; i < SAMPLES; i++)
+    {
+        stats.add(samples[i][0], samples[i][1]);
+    }
+    CHECK(stats.getWindow(&s) == false);
+    CHECK(stats.getSummary(&s));
+    compare(&s, SAMPLES - N, N);
+}
+
+static void testCap()
+{
+    /* Cumulative accumulation stops at 65535 samples */
+    TD_SHT31Statistics stats;
+    TD_SHT31Summary s;
+    for (uint32_t i = 0; i < 70000; i++)
+    {
+        stats.add((i < 65535) ? 13000 : -4500, (i & 1) ? 10000 : 0);
+    }
+    CHECK_EQ(stats.count(), 65535);
+    CHECK(stats.getSummary(&s));
+    CHECK_EQ(s.tMin, 13000);
+    CHECK_EQ(s.tMean, 13000);
+    CHECK_EQ(s.tVariance, 0);
+    CHECK_EQ(s.hMean, 5000);
+    CHECK_NEAR(s.hVariance, 25000000.0 * 65535 / 65534, 1.0);
+
+    /* Tumbling window of 65535 samples latches */
+    TD_SHT31Statistics window(65535);
+    for (uint32_t i = 0; i < 65535; i++)
+    {
+        window.add(-4500, 10000);
+    }
+    CHECK(window.getWindow(&s));
+    CHECK_EQ(s.count, 65535);
+    CHECK_EQ(s.tMean, -4500);
+    CHECK_EQ(window.count(), 0);
+}
+
+static void testIsqrt()
+{
+    uint32_t u32Errors = 0;
+    for (uint32_t r = 0; r <= 0xFFFF; r++)
+    {
+        uint32_t square = r * r;
+        if (TD_SHT31Statistics::isqrt(square) != r)
+        {
+            u32Errors++;
+        }
+        if ((r != 0) && (TD_SHT31Statistics::isqrt(square - 1) != r - 1))
+        {
+            u32Errors++;
+        }
+        uint32_t value = seed = seed * 1103515245UL + 12345;
+        if (TD_SHT31Statistics::isqrt(value) != (uint16_t) floor(sqrt((double) value)))
+        {
+            u32Errors++;
+        }
+    }
+    CHECK_EQ(u32Errors, 0);
+    CHECK_EQ(TD_SHT31Statistics::isqrt(0xFFFFFFFFUL), 0xFFFF);
+}
+
+int main()
+{
+    /* Full sensor range and typical narrow spread */
+    for (uint16_t i = 0; i < SAMPLES; i++)
+    {
+        samples[i][0] = (i < SAMPLES / 2) ? next(-4500, 13000) : next(2000, 2100);
+        samples[i][1] = next(0, 10000);
+    }
+    testCumulative();
+    testTumbling();
+    testRolling<4>();
+    testRolling<128>();
+    testRolling<255>();
+    testCap();
+    testIsqrt();
+    return checkSummary("test_statistics");
+}
@@ -0,0 +1,202 @@
+/**
+ * ----------------------------------------------------------------------------
+ * @file test_transport.cpp
+ * @brief TD_SHT31Transport queue ordering with asynchronous fake backend.
+ * @details Backend starts transfers from yield(), or only from explicit
+ * service() calls when hook is removed.
+ * ----------------------------------------------------------------------------
+*/
+#include "TD_SHT31.h"
+#include "TD_SHT31Transport.h"
+#include "SHT31Model.h"
+#include "check.h"
+
+/**
+ * @brief Backend completing transfers later, from yield().
+*/
+class AsyncTransport : public TD_SHT31WireTransport
+{
+    public:
+    AsyncTransport() : TD_SHT31WireTransport(&Wire), pending(NULL), started(0) {}
+
+    void service()
+    {
+        TD_SHT31Transfer *transfer = pending;
+        if (transfer != NULL)
+        {
+            pending = NULL;
+            TD_SHT31WireTransport::start(transfer);
+        }
+    }
+
+    TD_SHT31Transfer *pending;
+    uint32_t started;
+
+    protected:
+    virtual void start(TD_SHT31Transfer *transfer)
+    {
+        started++;
+        pending = transfer;
+    }
+};
+
+static AsyncTransport transport;
+static TD_SHT31Transfer chained;
+static uint32_t pinCalls;
+static uint32_t pinBusy;
+
+static void serviceTransport()
+{
+    transport.service();
+}
+
+static void onPin(uint8_t pin)
+{
+    (void) pin;
+    pinCalls++;
+    if (transport.isIdle() == false)
+    {
+        pinBusy++;
+    }
+}
+
+/* Foreign transfer queued behind sensor transfer */
+static void chainProbe(TD_SHT31Transfer *transfer)
+{
+    (void) transfer;
+    chained.address  = 0x45;
+    chained.writeLen = 0;
+    chained.readLen  = 0;
+    chained.callback = NULL;
+    chained.state    = XFER_IDLE;
+    transport.submit(&chained);
+}
+
+static void initProbe(TD_SHT31Transfer *transfer, uint8_t address)
+{
+    memset(transfer, 0, sizeof(*transfer));
+    transfer->address = address;
+    transfer->state   = XFER_IDLE;
+}
+
+int main()
+{
+    SHT31Model a(0x44);
+    SHT31Model b(0x45);
+    Wire.attach(&a);
+    Wire.attach(&b);
+    hostYieldHook = serviceTransport;
+
+    /* General call reset of begin goes through queue */
+    TD_SHT31 shtA(0x44);
+    TD_SHT31 shtB(0x45);
+    shtA.setTransport(&transport);
+    shtB.setTransport(&transport);
+    Wire.clearLog();
+    CHECK(shtA.begin(&Wire));
+    CHECK(transport.started >= 2);
+    CHECK(shtB.begin(&Wire));
+    CHECK(transport.isIdle());
+
+    /* Transfers of both sensors reach bus in submit order */
+    TD_SHT31Transfer first;
+    TD_SHT31Transfer second;
+    initProbe(&first, 0x45);
+    initProbe(&second, 0x44);
+    CHECK(transport.submit(&first));
+    CHECK(transport.submit(&second));
+    Wire.clearLog();
+    float fT;
+    float fH;
+    CHECK(shtB.runSingleShot(CMD_SS_CSD_HIGH, &fT, &fH));
+    CHECK_EQ(first.state, XFER_DONE);
+    CHECK_EQ(second.state, XFER_DONE);
+    CHECK(Wire.logCount >= 4);
+    CHECK_EQ(Wire.log[0].address, 0x45);
+    CHECK_EQ(Wire.log[0].len, 0);
+    CHECK_EQ(Wire.log[1].address, 0x44);
+    CHECK_EQ(Wire.log[1].len, 0);
+    CHECK_EQ(Wire.log[2].address, 0x45);
+    CHECK(Wire.log[2].read == false);
+    CHECK_EQ(Wire.log[2].len, 2);
+    CHECK_EQ(Wire.collisions, 0);
+
+    /* Command and response are one descriptor with repeated start */
+    Wire.clearLog();
+    CHECK(shtB.readSensorStatus() != 0xFFFF);
+    CHECK_EQ(Wire.logCount, 2);
+    CHECK(Wire.log[1].read);
+    CHECK(Wire.log[1].repeatedStart);
+
+    /* Bus recovery waits until foreign transfer is done */
+    shtA.set_defaults(ENABLE_CRC, CELSIUS, 4, 5);
+    shtA.setRetryPolicy(2, 0, RETRY_BUS_RECOVERY);
+    hostPinHook = onPin;
+    a.nackNext = 1;
+    TD_SHT31Transfer trigger;
+    initProbe(&trigger, 0x45);
+    trigger.callback = chainProbe;
+    CHECK(transport.submit(&trigger));
+    CHECK(shtA.readSensorStatus() != 0xFFFF);
+    CHECK_EQ(chained.state, XFER_DONE);
+    CHECK(pinCalls > 0);
+    CHECK_EQ(pinBusy, 0);
+    hostPinHook = NULL;
+
+    /* Start and poll return before backend has started transfer */
+    hostYieldHook = NULL;
+    hostYieldCalls = 0;
+    Wire.clearLog();
+    TD_SHT31Measurement m;
+    CHECK_EQ(shtB.startMeasurement(CMD_SS_CSD_HIGH, &m), MEAS_PENDING);
+    CHECK(transport.pending != NULL);
+    hostAdvance(20000);
+    CHECK_EQ(shtB.pollMeasurement(&m), MEAS_PENDING);
+    CHECK_EQ(Wire.logCount, 0);
+    transport.service();
+    CHECK_EQ(Wire.logCount, 1);
+    CHECK_EQ(shtB.pollMeasurement(&m), MEAS_PENDING);  /* Conversion time restarts */
+    CHECK(transport.pending == NULL);
+    hostAdvance(20000);
+    CHECK_EQ(shtB.pollMeasurement(&m), MEAS_PENDING);  /* Read queued */
+    CHECK(transport.pending != NULL);
+    CHECK_EQ(Wire.logCount, 1);
+    transport.service();
+    CHECK_EQ(shtB.pollMeasurement(&m), MEAS_READY);
+    CHECK(m.ok());
+    CHECK_EQ(Wire.logCount, 2);
+    CHECK_EQ(hostYieldCalls, 0);
+
+    /* Blocking call keeps result of queued read */
+    CHECK_EQ(shtB.startMeasurement(CMD_SS_CSD_HIGH, &m), MEAS_PENDING);
+    transport.service();
+    CHECK_EQ(shtB.pollMeasurement(&m), MEAS_PENDING);
+    hostAdvance(20000);
+    CHECK_EQ(shtB.pollMeasurement(&m), MEAS_PENDING);
+    CHECK(transport.pending != NULL);
+    hostYieldHook = serviceTransport;
+    CHECK(shtB.readSensorStatus() != 0xFFFF);
+    hostYieldHook = NULL;
+    CHECK_EQ(shtB.pollMeasurement(&m), MEAS_READY);
+    CHECK(m.ok());
+
+    /* Fetch command and read are one queued transfer */
+    hostYieldHook = serviceTransport;
+    CHECK(shtB.startPeriodic(PER_RATE_10, REPEAT_HIGH));
+    hostYieldHook = NULL;
+    hostYieldCalls = 0;
+    hostAdvance(150000);
+    Wire.clearLog();
+    CHECK_EQ(shtB.pollFetch(&m), MEAS_PENDING);
+    CHECK_EQ(Wire.logCount, 0);
+    transport.service();
+    CHECK_EQ(Wire.logCount, 2);
+    CHECK(Wire.log[1].repeatedStart);
+    CHECK_EQ(shtB.pollFetch(&m), MEAS_READY);
+    CHECK(m.ok());
+    CHECK_EQ(hostYieldCalls, 0);
+    hostYieldHook = serviceTransport;
+    CHECK(shtB.stopPeriodic());
+
+    return checkSummary("test_transport");
+}